@@ -0,0 +1,217 @@
+#pragma once
+#include "chords.hpp"
+#include "scales.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace musicpp {
+
+namespace detail {
+// Everything key analysis reads from a voicing: the lowest MIDI pitch of
+// each pitch class (roots are those notes, simplified) and the spelling of
+// the bass, plus the scale's pitch classes.
+struct analysis_cache_key {
+  std::array<std::int16_t, 12> lowest{};
+  std::int8_t bass{0};
+  std::uint64_t scale{0};
+
+  constexpr bool operator==(const analysis_cache_key &) const noexcept = default;
+
+  [[nodiscard]] constexpr std::uint64_t hash() const noexcept {
+    auto mix = [](std::uint64_t x) {
+      x ^= x >> 30;
+      x *= 0xbf58476d1ce4e5b9ull;
+      x ^= x >> 27;
+      x *= 0x94d049bb133111ebull;
+      return x ^ (x >> 31);
+    };
+    std::uint64_t h = mix(scale ^ static_cast<std::uint8_t>(bass));
+    for (std::size_t i = 0; i < lowest.size(); i += 4) {
+      std::uint64_t word = 0;
+      for (std::size_t j = 0; j < 4; ++j)
+        word |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(lowest[i + j])) << (16 * j);
+      h = mix(h ^ std::rotl(word, 17));
+    }
+    return h;
+  }
+};
+
+template <std::size_t N>
+constexpr void voicing_key(analysis_cache_key &key,
+                           const std::array<note, N> &notes) noexcept {
+  static_assert(N > 0, "Cached key analysis needs at least one chord tone");
+  key.lowest.fill(INT16_MAX);
+  const note *bass = &notes[0];
+  for (const auto &n : notes) {
+    auto pc = static_cast<std::size_t>(n.get_pitch());
+    auto midi = static_cast<std::int16_t>(n.get_midi_pitch());
+    key.lowest[pc] = std::min(key.lowest[pc], midi);
+    if (midi < bass->get_midi_pitch())
+      bass = &n;
+  }
+  key.bass = bass->get_fifth();
+}
+
+template <std::size_t S>
+[[nodiscard]] constexpr std::uint64_t
+scale_key(const std::array<note, S> &notes) noexcept {
+  static_assert(S <= 12, "Cached key analysis supports scales up to 12 notes");
+  std::uint64_t key = S;
+  for (std::size_t i = 0; i < S; ++i)
+    key |= static_cast<std::uint64_t>(notes[i].get_pitch()) << (4 * i + 4);
+  return key;
+}
+}
+
+class key_analysis_cache {
+public:
+  explicit key_analysis_cache(std::size_t capacity = 1u << 14,
+                              std::size_t shard_count = 16)
+      : m_shards(std::bit_ceil(std::max<std::size_t>(shard_count, 1))) {
+    auto per_shard = std::bit_ceil(
+        std::max<std::size_t>(capacity / m_shards.size(), 16));
+    for (auto &s : m_shards)
+      s.slots = std::make_unique<std::atomic<entry *>[]>(per_shard);
+    m_shard_capacity = per_shard;
+  }
+
+  key_analysis_cache(const key_analysis_cache &) = delete;
+  key_analysis_cache &operator=(const key_analysis_cache &) = delete;
+
+  ~key_analysis_cache() {
+    for (auto &s : m_shards) {
+      for (std::size_t i = 0; i < m_shard_capacity; ++i)
+        delete s.slots[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  // The result is shared by every chord with the same lowest pitch per
+  // pitch class and bass spelling, and lives as long as the cache.
+  template <std::size_t N, std::size_t S>
+  [[nodiscard]] const key_analysis_result &
+  analyze(const chord_instance<N> &chord, const scale_instance<S> &key) {
+    detail::analysis_cache_key k;
+    detail::voicing_key(k, chord.notes);
+    k.scale = detail::scale_key(key.notes);
+    auto make = [&] {
+      return std::make_unique<entry>(k, detail::analyze_in_key(chord.notes, key.notes));
+    };
+    auto h = k.hash();
+    auto &s = m_shards[h & (m_shards.size() - 1)];
+    auto mask = m_shard_capacity - 1;
+    auto start = static_cast<std::size_t>(h >> 32) & mask;
+
+    for (std::size_t i = 0; i < m_shard_capacity; ++i) {
+      auto *e = s.slots[(start + i) & mask].load(std::memory_order_acquire);
+      if (!e)
+        return insert(s, start, k, make);
+      if (e->key == k) {
+        s.hits.fetch_add(1, std::memory_order_relaxed);
+        return e->value;
+      }
+    }
+    return find_overflow(s, k, make);
+  }
+
+  [[nodiscard]] std::uint64_t hits() const noexcept {
+    std::uint64_t n = 0;
+    for (const auto &s : m_shards)
+      n += s.hits.load(std::memory_order_relaxed);
+    return n;
+  }
+
+  [[nodiscard]] std::uint64_t misses() const noexcept {
+    std::uint64_t n = 0;
+    for (const auto &s : m_shards)
+      n += s.misses.load(std::memory_order_relaxed);
+    return n;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    std::size_t n = 0;
+    for (const auto &s : m_shards)
+      n += s.size.load(std::memory_order_relaxed);
+    return n;
+  }
+
+  [[nodiscard]] std::size_t capacity() const noexcept {
+    return m_shard_capacity * m_shards.size();
+  }
+
+private:
+  struct entry {
+    detail::analysis_cache_key key;
+    key_analysis_result value;
+  };
+
+  struct alignas(64) shard {
+    std::unique_ptr<std::atomic<entry *>[]> slots;
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::size_t> size{0};
+    std::mutex overflow_mutex;
+    std::vector<std::unique_ptr<entry>> overflow;
+  };
+
+  template <typename Make>
+  const key_analysis_result &insert(shard &s, std::size_t start,
+                                    const detail::analysis_cache_key &k,
+                                    Make make) {
+    s.misses.fetch_add(1, std::memory_order_relaxed);
+    auto fresh = make();
+    auto mask = m_shard_capacity - 1;
+    for (std::size_t i = 0; i < m_shard_capacity; ++i) {
+      auto &slot = s.slots[(start + i) & mask];
+      entry *expected = nullptr;
+      if (slot.compare_exchange_strong(expected, fresh.get(),
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+        s.size.fetch_add(1, std::memory_order_relaxed);
+        return fresh.release()->value;
+      }
+      if (expected->key == k)
+        return expected->value;
+    }
+    return insert_overflow(s, std::move(fresh));
+  }
+
+  const key_analysis_result &insert_overflow(shard &s,
+                                             std::unique_ptr<entry> fresh) {
+    std::lock_guard lock(s.overflow_mutex);
+    for (const auto &e : s.overflow) {
+      if (e->key == fresh->key)
+        return e->value;
+    }
+    s.overflow.push_back(std::move(fresh));
+    s.size.fetch_add(1, std::memory_order_relaxed);
+    return s.overflow.back()->value;
+  }
+
+  template <typename Make>
+  const key_analysis_result &
+  find_overflow(shard &s, const detail::analysis_cache_key &k, Make make) {
+    {
+      std::lock_guard lock(s.overflow_mutex);
+      for (const auto &e : s.overflow) {
+        if (e->key == k) {
+          s.hits.fetch_add(1, std::memory_order_relaxed);
+          return e->value;
+        }
+      }
+    }
+    s.misses.fetch_add(1, std::memory_order_relaxed);
+    return insert_overflow(s, make());
+  }
+
+  std::vector<shard> m_shards;
+  std::size_t m_shard_capacity{0};
+};
+
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include "chords.hpp"
+#include "notes.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace musicpp {
+
+namespace detail {
+inline constexpr std::size_t batch_block = 64;
+
+template <std::size_t N> struct chord_block {
+  std::array<std::array<std::int8_t, batch_block>, N> pitch;
+  std::array<std::array<std::int8_t, batch_block>, N> midi;
+  std::array<std::uint16_t, batch_block> present;
+  std::array<std::array<std::int16_t, batch_block>, 12> lowest_midi;
+  std::array<std::array<std::uint8_t, batch_block>, 12> lowest_index;
+  std::array<std::array<std::uint16_t, batch_block>, 12> rotations;
+};
+
+template <std::size_t N, std::size_t Capacity>
+void analyze_block(std::span<const chord_instance<N>> chords,
+                   std::span<compact_analysis_result<Capacity>> out,
+                   chord_block<N> &block) noexcept {
+  const auto count = chords.size();
+
+  for (std::size_t j = 0; j < N; ++j) {
+    for (std::size_t b = 0; b < count; ++b) {
+      const auto &n = chords[b].notes[j];
+      block.pitch[j][b] = fifth_pitch_classes[static_cast<std::uint8_t>(n.get_fifth())];
+      block.midi[j][b] = n.get_midi_pitch();
+    }
+  }
+
+  block.present.fill(0);
+  for (std::size_t j = 0; j < N; ++j) {
+    for (std::size_t b = 0; b < count; ++b)
+      block.present[b] |= static_cast<std::uint16_t>(1u << block.pitch[j][b]);
+  }
+
+  for (std::size_t pc = 0; pc < 12; ++pc) {
+    block.lowest_midi[pc].fill(INT16_MAX);
+    block.lowest_index[pc].fill(0);
+    for (std::size_t j = 0; j < N; ++j) {
+      for (std::size_t b = 0; b < count; ++b) {
+        bool lower = block.pitch[j][b] == static_cast<std::int8_t>(pc) &&
+                     block.midi[j][b] < block.lowest_midi[pc][b];
+        block.lowest_midi[pc][b] = lower ? block.midi[j][b] : block.lowest_midi[pc][b];
+        block.lowest_index[pc][b] = lower ? static_cast<std::uint8_t>(j)
+                                          : block.lowest_index[pc][b];
+      }
+    }
+  }
+
+  for (std::size_t r = 0; r < 12; ++r) {
+    for (std::size_t b = 0; b < count; ++b)
+      block.rotations[r][b] =
+          rotate_pcs(block.present[b], static_cast<int>(r));
+  }
+
+  for (std::size_t b = 0; b < count; ++b) {
+    const auto &notes = chords[b].notes;
+    auto &result = out[b];
+    result.clear();
+
+    std::array<std::uint8_t, 12> roots{};
+    std::size_t root_count = 0;
+    for (std::size_t pc = 0; pc < 12; ++pc) {
+      if (!(block.present[b] & (1u << pc)))
+        continue;
+      auto pos = root_count++;
+      while (pos > 0 && block.lowest_midi[roots[pos - 1]][b] >
+                            block.lowest_midi[pc][b]) {
+        roots[pos] = roots[pos - 1];
+        --pos;
+      }
+      roots[pos] = static_cast<std::uint8_t>(pc);
+    }
+    if (root_count == 0)
+      continue;
+
+    const auto &lowest = notes[block.lowest_index[roots[0]][b]];
+    for (std::size_t k = 0; k < root_count; ++k) {
+      auto pc = roots[k];
+      const auto &root = notes[block.lowest_index[pc][b]];
+      for (const auto &m : find_matches(block.rotations[pc][b]))
+        result.insert(build_analysis(root, m, chord_db[m.chord], lowest));
+    }
+  }
+}
+}
+
+template <std::size_t N, std::size_t Capacity>
+void analyze_batch(std::span<const chord_instance<N>> chords,
+                   std::span<compact_analysis_result<Capacity>> out) noexcept {
+  static_assert(N <= 255, "Batch analysis supports up to 255 chord tones");
+  detail::chord_block<N> block;
+  auto count = std::min(chords.size(), out.size());
+  for (std::size_t first = 0; first < count; first += detail::batch_block) {
+    auto len = std::min(detail::batch_block, count - first);
+    detail::analyze_block(chords.subspan(first, len), out.subspan(first, len),
+                          block);
+  }
+}
+
+template <std::size_t N>
+[[nodiscard]] std::vector<compact_analysis_result<>>
+analyze_batch(std::span<const chord_instance<N>> chords) {
+  std::vector<compact_analysis_result<>> out(chords.size());
+  analyze_batch(chords, std::span{out});
+  return out;
+}
+
+}
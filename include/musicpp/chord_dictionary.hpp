@@ -0,0 +1,175 @@
+#pragma once
+#include "chords.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace musicpp {
+
+namespace detail {
+struct dictionary_data {
+  std::vector<std::string> names;
+  std::vector<chord_info> infos;
+  std::array<pcs_slot, 4096> slots{};
+  std::vector<pcs_match> matches;
+  std::size_t max_interpretations{0};
+};
+
+struct ranked_analyses {
+  std::vector<compact_analysis> interpretations;
+
+  void insert(const compact_analysis &a) {
+    auto pos = std::ranges::upper_bound(interpretations, a, ranks_before);
+    interpretations.insert(pos, a);
+  }
+};
+}
+
+class chord_dictionary_builder;
+
+class chord_dictionary {
+public:
+  chord_dictionary();
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_data->infos.size(); }
+
+  [[nodiscard]] std::string_view name(std::size_t i) const noexcept {
+    return m_data->infos[i].name;
+  }
+
+  [[nodiscard]] bool contains(std::string_view quality) const noexcept {
+    return std::ranges::any_of(m_data->infos, [&](const auto &info) {
+      return info.name == quality;
+    });
+  }
+
+  [[nodiscard]] std::span<const detail::chord_info> infos() const noexcept {
+    return m_data->infos;
+  }
+
+  [[nodiscard]] detail::match_table table() const noexcept {
+    return {m_data->slots.data(), m_data->matches.data(), m_data->infos.data()};
+  }
+
+  [[nodiscard]] std::span<const detail::pcs_match>
+  find(std::uint16_t pitch_class_set) const noexcept {
+    return table()[pitch_class_set];
+  }
+
+  [[nodiscard]] std::size_t max_interpretations() const noexcept {
+    return m_data->max_interpretations;
+  }
+
+private:
+  friend class chord_dictionary_builder;
+
+  explicit chord_dictionary(std::shared_ptr<const detail::dictionary_data> data)
+      : m_data(std::move(data)) {}
+
+  std::shared_ptr<const detail::dictionary_data> m_data;
+};
+
+class chord_dictionary_builder {
+public:
+  chord_dictionary_builder() {
+    for (const auto &info : detail::chord_db)
+      m_entries.push_back({std::string(info.name), info});
+  }
+
+  // Names must be unique; a pattern may repeat an existing pitch class set,
+  // which adds an alias reported alongside the original quality.
+  template <std::size_t N>
+  chord_dictionary_builder &add(std::string_view name,
+                                const chord_pattern<N> &pattern) {
+    auto info = detail::make_chord_info({}, pattern);
+    if (!(info.pitch_class_set & 1u))
+      throw std::invalid_argument("chord pattern must contain the root");
+    if (std::ranges::any_of(m_entries, [&](const entry &e) { return e.name == name; }))
+      throw std::invalid_argument("chord quality name is already defined");
+    m_entries.push_back({std::string(name), info});
+    return *this;
+  }
+
+  chord_dictionary_builder &clear() noexcept {
+    m_entries.clear();
+    return *this;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_entries.size(); }
+
+  [[nodiscard]] chord_dictionary build() const {
+    if (m_entries.size() > UINT16_MAX + 1u)
+      throw std::length_error("chord dictionary holds at most 65536 entries");
+
+    auto data = std::make_shared<detail::dictionary_data>();
+    data->names.reserve(m_entries.size());
+    data->infos.reserve(m_entries.size());
+    for (const auto &e : m_entries)
+      data->names.push_back(e.name);
+    for (std::size_t i = 0; i < m_entries.size(); ++i) {
+      auto info = m_entries[i].info;
+      info.name = data->names[i];
+      data->infos.push_back(info);
+    }
+
+    data->matches.resize(detail::count_pcs_matches(data->infos));
+    detail::fill_pcs_table(data->infos, data->slots, data->matches);
+    data->max_interpretations = detail::count_max_interpretations(
+        {data->slots.data(), data->matches.data(), data->infos.data()});
+    return chord_dictionary{std::move(data)};
+  }
+
+private:
+  struct entry {
+    std::string name;
+    detail::chord_info info;
+  };
+
+  std::vector<entry> m_entries;
+};
+
+inline chord_dictionary::chord_dictionary()
+    : m_data([] {
+        static const auto builtin = chord_dictionary_builder{}.build();
+        return builtin.m_data;
+      }()) {}
+
+template <std::size_t N>
+[[nodiscard]] inline analysis_result
+chord_instance<N>::analyze(const chord_dictionary &dict) const {
+  detail::ranked_analyses ranked;
+  detail::analyze_compact(notes, ranked, dict.table());
+  analysis_result result;
+  result.interpretations.reserve(ranked.interpretations.size());
+  for (const auto &a : ranked.interpretations)
+    result.interpretations.push_back(a.expand());
+  return result;
+}
+
+// By default the result is sized from the dictionary and holds every
+// interpretation; an explicit Capacity keeps only the best that many. Each
+// interpretation points at the dictionary's chord_info, so the result must
+// not outlive the last chord_dictionary sharing that vocabulary.
+template <std::size_t N>
+template <std::size_t Capacity>
+[[nodiscard]] inline auto
+chord_instance<N>::analyze_compact(const chord_dictionary &dict) const {
+  if constexpr (Capacity == std::dynamic_extent) {
+    compact_analysis_result<std::dynamic_extent> result(dict.max_interpretations());
+    detail::analyze_compact(notes, result, dict.table());
+    return result;
+  } else {
+    compact_analysis_result<Capacity> result;
+    detail::analyze_compact(notes, result, dict.table());
+    return result;
+  }
+}
+
+}
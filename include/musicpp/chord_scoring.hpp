@@ -0,0 +1,244 @@
+#pragma once
+#include "chord_dictionary.hpp"
+#include "chords.hpp"
+#include "notes.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+
+namespace musicpp {
+
+struct match_weights {
+  int added{2};
+  int missing{3};
+  int missing_root{4};
+};
+
+struct scored_analysis {
+  compact_analysis analysis;
+  std::uint16_t added{0};
+  std::uint16_t missing{0};
+  int score{0};
+
+  [[nodiscard]] constexpr bool exact() const noexcept {
+    return added == 0 && missing == 0;
+  }
+  [[nodiscard]] constexpr bool root_missing() const noexcept {
+    return missing & 1u;
+  }
+  [[nodiscard]] constexpr chord_name name() const noexcept {
+    return analysis.name();
+  }
+
+  constexpr bool operator==(const scored_analysis &) const noexcept = default;
+
+  [[nodiscard]] std::string str() const { return analysis.str(); }
+
+  friend std::ostream &operator<<(std::ostream &os, const scored_analysis &a) {
+    return os << a.str();
+  }
+};
+
+namespace detail {
+[[nodiscard]] constexpr bool scores_before(const scored_analysis &a,
+                                           const scored_analysis &b) noexcept {
+  if (a.score != b.score)
+    return a.score < b.score;
+  if (std::popcount(a.missing) != std::popcount(b.missing))
+    return std::popcount(a.missing) < std::popcount(b.missing);
+  return ranks_before(a.analysis, b.analysis);
+}
+}
+
+template <std::size_t K = 5> struct scored_analysis_result {
+  static_assert(K > 0, "Top-k result needs room for at least one entry");
+
+  std::array<scored_analysis, K> interpretations{};
+  std::size_t count{0};
+
+  [[nodiscard]] static constexpr std::size_t capacity() noexcept { return K; }
+  [[nodiscard]] constexpr bool empty() const noexcept { return count == 0; }
+  [[nodiscard]] constexpr std::size_t size() const noexcept { return count; }
+  [[nodiscard]] constexpr const scored_analysis &
+  operator[](std::size_t i) const noexcept {
+    return interpretations[i];
+  }
+  [[nodiscard]] constexpr auto begin() const noexcept {
+    return interpretations.begin();
+  }
+  [[nodiscard]] constexpr auto end() const noexcept {
+    return interpretations.begin() + static_cast<std::ptrdiff_t>(count);
+  }
+
+  constexpr void clear() noexcept { count = 0; }
+
+  [[nodiscard]] constexpr bool admits(int score) const noexcept {
+    return count < K || score <= interpretations[K - 1].score;
+  }
+
+  constexpr void insert(const scored_analysis &a) noexcept {
+    auto pos = count;
+    while (pos > 0 && detail::scores_before(a, interpretations[pos - 1]))
+      --pos;
+    if (pos >= K)
+      return;
+    auto last = count < K ? count : K - 1;
+    for (auto i = last; i > pos; --i)
+      interpretations[i] = interpretations[i - 1];
+    interpretations[pos] = a;
+    if (count < K)
+      ++count;
+  }
+
+  [[nodiscard]] std::string str() const {
+    if (empty())
+      return "?";
+    std::string s;
+    for (std::size_t i = 0; i < count; ++i) {
+      if (i > 0)
+        s += " | ";
+      s += interpretations[i].str();
+    }
+    return s;
+  }
+
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const scored_analysis_result &r) {
+    return os << r.str();
+  }
+};
+
+namespace detail {
+[[nodiscard]] constexpr note spell_below(int pitch_class,
+                                         const note &reference) noexcept {
+  int fifth = (pitch_class * 7) % 12;
+  int ref = reference.get_fifth();
+  while (fifth > ref + 6)
+    fifth -= 12;
+  while (fifth < ref - 5)
+    fifth += 12;
+  int offset = reference.get_midi_pitch() - 12 - fifth * 7;
+  int octave = offset >= 0 ? offset / 12 : -((-offset + 11) / 12);
+  auto candidate = note(static_cast<std::int8_t>(fifth),
+                        static_cast<std::int8_t>(octave));
+  if (candidate.get_midi_pitch() + 12 <= reference.get_midi_pitch())
+    candidate = note(static_cast<std::int8_t>(fifth),
+                     static_cast<std::int8_t>(octave + 1));
+  return candidate;
+}
+
+template <std::size_t M, std::size_t K>
+constexpr void analyze_scored(const std::array<note, M> &notes,
+                              std::span<const chord_info> infos,
+                              const match_weights &weights,
+                              scored_analysis_result<K> &result) noexcept {
+  result.clear();
+  if constexpr (M == 0) {
+    return;
+  } else {
+    std::array<std::size_t, 12> lowest_of{};
+    std::uint16_t present = 0;
+    std::size_t lowest = 0;
+    for (std::size_t i = 0; i < M; ++i) {
+      auto pc = notes[i].get_pitch();
+      auto midi = notes[i].get_midi_pitch();
+      if (!(present & (1u << pc)) ||
+          midi < notes[lowest_of[pc]].get_midi_pitch())
+        lowest_of[pc] = i;
+      present |= static_cast<std::uint16_t>(1u << pc);
+      if (midi < notes[lowest].get_midi_pitch())
+        lowest = i;
+    }
+
+    std::array<note, 12> roots{};
+    std::size_t root_count = 0;
+    for (int pc = 0; pc < 12; ++pc) {
+      if (!(present & (1u << pc)))
+        continue;
+      const auto &n = notes[lowest_of[pc]];
+      auto pos = root_count++;
+      while (pos > 0 && roots[pos - 1].get_midi_pitch() > n.get_midi_pitch()) {
+        roots[pos] = roots[pos - 1];
+        --pos;
+      }
+      roots[pos] = n;
+    }
+    for (int pc = 0; pc < 12; ++pc) {
+      if (!(present & (1u << pc)))
+        roots[root_count++] = spell_below(pc, notes[lowest]);
+    }
+
+    std::array<std::uint8_t, 12> present_counts{};
+    std::array<std::uint16_t, 12> rotations{};
+    for (std::size_t r = 0; r < 12; ++r) {
+      rotations[r] = rotate_pcs(present, roots[r].get_pitch());
+      present_counts[r] = pcs_popcount[rotations[r]];
+    }
+    auto score_of = [&](std::size_t r, const chord_info &info) {
+      auto common = pcs_popcount[rotations[r] & info.pitch_class_set];
+      bool root = rotations[r] & info.pitch_class_set & 1u;
+      return common == 0 ? -1
+                         : weights.added * (present_counts[r] - common) +
+                               weights.missing * (pcs_popcount[info.pitch_class_set] - common) +
+                               (root ? 0 : weights.missing_root);
+    };
+
+    std::array<int, K> best{};
+    std::size_t best_count = 0;
+    for (std::size_t r = 0; r < 12; ++r) {
+      for (const auto &info : infos) {
+        auto score = score_of(r, info);
+        if (score < 0 || (best_count == K && score >= best[K - 1]))
+          continue;
+        auto pos = best_count < K ? best_count++ : K - 1;
+        for (; pos > 0 && best[pos - 1] > score; --pos)
+          best[pos] = best[pos - 1];
+        best[pos] = score;
+      }
+    }
+    if (best_count == 0)
+      return;
+
+    for (std::size_t r = 0; r < 12; ++r) {
+      for (std::size_t i = 0; i < infos.size(); ++i) {
+        auto score = score_of(r, infos[i]);
+        if (score < 0 || score > best[best_count - 1])
+          continue;
+        auto tones = infos[i].pitch_class_set;
+        auto added = static_cast<std::uint16_t>(rotations[r] & ~tones);
+        auto missing = static_cast<std::uint16_t>(tones & ~rotations[r]);
+        pcs_match match{static_cast<std::uint16_t>(i),
+                        static_cast<std::uint16_t>(missing & ~1u)};
+        result.insert(
+            {build_analysis(roots[r], match, infos[i], notes[lowest]), added,
+             missing, score});
+      }
+    }
+  }
+}
+}
+
+template <std::size_t K = 5, std::size_t N>
+[[nodiscard]] constexpr scored_analysis_result<K>
+analyze_scored(const chord_instance<N> &chord,
+               const match_weights &weights = {}) noexcept {
+  scored_analysis_result<K> result;
+  detail::analyze_scored(chord.notes, std::span{detail::chord_db}, weights,
+                         result);
+  return result;
+}
+
+template <std::size_t K = 5, std::size_t N>
+[[nodiscard]] scored_analysis_result<K>
+analyze_scored(const chord_instance<N> &chord, const chord_dictionary &dict,
+               const match_weights &weights = {}) noexcept {
+  scored_analysis_result<K> result;
+  detail::analyze_scored(chord.notes, dict.infos(), weights, result);
+  return result;
+}
+
+}
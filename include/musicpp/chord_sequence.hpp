@@ -1,6 +1,8 @@
 #pragma once
 #include "chords.hpp"
 #include "duration.hpp"
+#include "text.hpp"
+#include <array>
 #include <format>
 #include <ostream>
 #include <string>
@@ -10,6 +12,8 @@ namespace musicpp {
 
 struct time_signature;
 struct metric_position;
+class meter_map;
+class onset_index;
 
 
 template <std::size_t N> struct chord_event {
@@ -41,17 +45,32 @@ template <std::size_t N> struct chord_event {
   }
 
 
-  [[nodiscard]] std::string str() const {
-    if (is_rest)
-      return "-(" + dur.str() + ")";
-    auto a = chord.analyze();
-    auto name = a.empty() ? "?" : a[0].str();
-    auto s = name + "(" + dur.str() + ")";
-    if (is_tied)
-      s += "~";
-    return s;
+  [[nodiscard]] constexpr chord_name name() const noexcept {
+    chord_name result;
+    if (is_rest) {
+      result.append('-');
+      return result;
+    }
+    auto a = chord.analyze_compact();
+    if (a.empty()) {
+      result.append('?');
+      return result;
+    }
+    return a[0].name();
   }
 
+  template <typename Out> constexpr Out write_to(Out out) const {
+    out = detail::write_chars(out, name().view());
+    *out++ = '(';
+    out = dur.write_to(out);
+    *out++ = ')';
+    if (is_tied && !is_rest)
+      *out++ = '~';
+    return out;
+  }
+
+  [[nodiscard]] std::string str() const { return detail::to_text(*this); }
+
   [[nodiscard]] std::string notes_str() const {
     if (is_rest)
       return "-(" + dur.str() + ")";
@@ -134,9 +153,15 @@ template <typename... Events> struct chord_sequence {
   }
 
 
-  [[nodiscard]] constexpr duration total_duration() const noexcept {
-    duration sum{0, 1};
-    for_each([&](const auto &ev) { sum = sum + ev.dur; });
+  [[nodiscard]] constexpr wide_duration total_duration() const {
+    wide_duration sum;
+    for_each([&](const auto &ev) { sum += ev.dur; });
+    return sum.reduced();
+  }
+
+  [[nodiscard]] constexpr ticks total_ticks(timebase tb) const {
+    ticks sum{};
+    for_each([&](const auto &ev) { sum += tb.to_ticks(ev.dur); });
     return sum;
   }
 
@@ -155,6 +180,13 @@ template <typename... Events> struct chord_sequence {
     return result;
   }
 
+  [[nodiscard]] constexpr std::array<chord_name, length> names_ct() const noexcept {
+    std::array<chord_name, length> result{};
+    std::size_t i = 0;
+    for_each([&](const auto &ev) { result[i++] = ev.name(); });
+    return result;
+  }
+
   template <std::size_t S>
   [[nodiscard]] std::string roman(const scale_instance<S> &key) const {
     std::string result;
@@ -175,17 +207,28 @@ template <typename... Events> struct chord_sequence {
   template <typename F>
   constexpr void walk(time_signature ts, F &&f) const;
 
+  template <typename F>
+  constexpr void walk(time_signature ts, timebase tb, F &&f) const;
 
-  [[nodiscard]] std::string str() const {
-    std::string result;
+  template <typename F>
+  void walk(const meter_map &meters, F &&f) const;
+
+  [[nodiscard]] onset_index onsets() const;
+
+
+  template <typename Out> constexpr Out write_to(Out out) const {
+    bool first = true;
     for_each([&](const auto &ev) {
-      if (!result.empty())
-        result += ' ';
-      result += ev.str();
+      if (!first)
+        *out++ = ' ';
+      first = false;
+      out = ev.write_to(out);
     });
-    return result;
+    return out;
   }
 
+  [[nodiscard]] std::string str() const { return detail::to_text(*this); }
+
   [[nodiscard]] std::string notes_str() const {
     std::string result;
     for_each([&](const auto &ev) {
@@ -214,16 +257,8 @@ operator|(const chord_event<A> &a, const chord_event<B> &b) noexcept {
 
 template <std::size_t N>
 struct std::formatter<musicpp::chord_event<N>>
-    : std::formatter<std::string> {
-  auto format(const musicpp::chord_event<N> &ce, auto &ctx) const {
-    return std::formatter<std::string>::format(ce.str(), ctx);
-  }
-};
+    : musicpp::detail::text_formatter<musicpp::chord_event<N>> {};
 
 template <typename... Events>
 struct std::formatter<musicpp::chord_sequence<Events...>>
-    : std::formatter<std::string> {
-  auto format(const musicpp::chord_sequence<Events...> &cs, auto &ctx) const {
-    return std::formatter<std::string>::format(cs.str(), ctx);
-  }
-};
+    : musicpp::detail::text_formatter<musicpp::chord_sequence<Events...>> {};
@@ -0,0 +1,331 @@
+#pragma once
+#include "chords.hpp"
+#include "intervals.hpp"
+#include "notes.hpp"
+#include "text.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace musicpp {
+
+namespace detail {
+struct tension_name {
+  std::string_view name;
+  interval iv;
+};
+
+inline constexpr auto tension_names = std::to_array<tension_name>({
+    {"b9", intervals::m9},
+    {"9", intervals::M9},
+    {"#9", intervals::A9},
+    {"11", intervals::P11},
+    {"#11", intervals::A11},
+    {"b13", intervals::m13},
+    {"13", intervals::M13},
+});
+
+struct quality_index {
+  std::array<std::uint8_t, chord_db.size()> order{};
+  std::array<std::uint8_t, 129> first{};
+  std::uint8_t major{0};
+};
+
+consteval quality_index make_quality_index() {
+  static_assert(chord_db.size() < 256, "Quality index stores chord_db positions in a byte");
+  quality_index index;
+  for (std::size_t i = 0; i < chord_db.size(); ++i)
+    index.order[i] = static_cast<std::uint8_t>(i);
+  auto key = [](std::uint8_t i) {
+    auto name = chord_db[i].name;
+    return name.empty() ? 0u : static_cast<unsigned>(static_cast<unsigned char>(name[0]));
+  };
+  std::ranges::sort(index.order, [&](std::uint8_t a, std::uint8_t b) {
+    if (key(a) != key(b))
+      return key(a) < key(b);
+    return chord_db[a].name.size() > chord_db[b].name.size();
+  });
+  std::size_t pos = 0;
+  for (unsigned c = 0; c <= 128; ++c) {
+    while (pos < index.order.size() && key(index.order[pos]) < c)
+      ++pos;
+    index.first[c] = static_cast<std::uint8_t>(pos);
+  }
+  for (std::size_t i = 0; i < chord_db.size(); ++i) {
+    if (chord_db[i].name.empty())
+      index.major = static_cast<std::uint8_t>(i);
+  }
+  return index;
+}
+
+inline constexpr auto quality_lookup = make_quality_index();
+
+[[nodiscard]] constexpr std::size_t find_quality(std::string_view text) noexcept {
+  if (!text.empty() && static_cast<unsigned char>(text[0]) < 128) {
+    auto c = static_cast<unsigned char>(text[0]);
+    for (auto i = quality_lookup.first[c]; i < quality_lookup.first[c + 1]; ++i) {
+      auto candidate = quality_lookup.order[i];
+      if (text.starts_with(chord_db[candidate].name))
+        return candidate;
+    }
+  }
+  return quality_lookup.major;
+}
+
+constexpr const char *parse_tension(const char *first, const char *last,
+                                    interval &iv) noexcept {
+  std::string_view rest(first, static_cast<std::size_t>(last - first));
+  if (rest.starts_with("add"))
+    rest.remove_prefix(3);
+  auto skipped = static_cast<std::size_t>(last - first) - rest.size();
+  const tension_name *best = nullptr;
+  for (const auto &t : tension_names) {
+    if (rest.starts_with(t.name) && (!best || t.name.size() > best->name.size()))
+      best = &t;
+  }
+  if (!best)
+    return first;
+  iv = best->iv;
+  return first + skipped + best->name.size();
+}
+
+[[nodiscard]] constexpr bool is_symbol_separator(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '|' ||
+         c == ',';
+}
+}
+
+struct chord_symbol {
+  static constexpr std::size_t max_tensions = 4;
+
+  note root;
+  std::optional<note> bass;
+  const detail::chord_info *info{&detail::no_chord_info};
+  std::uint16_t omitted{0};
+  std::array<interval, max_tensions> tensions{};
+  std::uint8_t tension_count{0};
+
+  [[nodiscard]] constexpr std::string_view quality() const noexcept {
+    return info->name;
+  }
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept {
+    std::size_t n = tension_count;
+    for (std::size_t j = 0; j < info->tone_count && j < 7; ++j) {
+      if (!(omitted & (1u << info->interval_semitones[j])))
+        ++n;
+    }
+    return n;
+  }
+
+  constexpr std::size_t notes(std::span<note> out, int octave = 4) const noexcept {
+    auto shift = interval(0, static_cast<std::int8_t>(octave - 4));
+    std::size_t n = 0;
+    for (std::size_t j = 0; j < info->tone_count && j < 7; ++j) {
+      if (omitted & (1u << info->interval_semitones[j]))
+        continue;
+      if (n < out.size())
+        out[n] = root + info->intervals[j] + shift;
+      ++n;
+    }
+    for (std::size_t t = 0; t < tension_count; ++t) {
+      if (n < out.size())
+        out[n] = root + tensions[t] + shift;
+      ++n;
+    }
+    return std::min(n, out.size());
+  }
+
+  template <std::size_t N>
+  [[nodiscard]] constexpr chord_instance<N> chord(int octave = 4) const {
+    if (size() != N)
+      throw "chord symbol has a different number of tones";
+    chord_instance<N> result{};
+    notes(result.notes, octave);
+    return result;
+  }
+
+  template <std::size_t N>
+  [[nodiscard]] constexpr slash_chord_instance<N>
+  slash_chord(int octave = 4) const {
+    if (!bass)
+      throw "chord symbol has no bass note";
+    return {chord<N>(octave),
+            *bass + interval(0, static_cast<std::int8_t>(octave - 4))};
+  }
+
+  template <typename Out> constexpr Out write_to(Out out) const {
+    out = root.write_pitch_name(out);
+    out = detail::write_chars(out, quality());
+    bool first = true;
+    auto separator = [&] {
+      *out++ = first ? '(' : ',';
+      first = false;
+    };
+    for (std::size_t j = 1; j < info->tone_count && j < 7; ++j) {
+      auto semi = info->interval_semitones[j];
+      if (omitted & (1u << semi)) {
+        separator();
+        out = detail::write_chars(out, detail::semitone_to_omission_name(semi));
+      }
+    }
+    for (std::size_t t = 0; t < tension_count; ++t) {
+      separator();
+      for (const auto &name : detail::tension_names) {
+        if (name.iv == tensions[t]) {
+          out = detail::write_chars(out, name.name);
+          break;
+        }
+      }
+    }
+    if (!first)
+      *out++ = ')';
+    if (bass) {
+      *out++ = '/';
+      out = bass->write_pitch_name(out);
+    }
+    return out;
+  }
+
+  [[nodiscard]] std::string str() const { return detail::to_text(*this); }
+
+  constexpr bool operator==(const chord_symbol &) const noexcept = default;
+
+  friend std::ostream &operator<<(std::ostream &os, const chord_symbol &s) {
+    return os << s.str();
+  }
+};
+
+constexpr std::from_chars_result from_chars(const char *first, const char *last,
+                                            chord_symbol &value) noexcept {
+  chord_symbol result;
+  int fifth = 0;
+  auto p = detail::parse_pitch_name(first, last, fifth);
+  if (p == first || detail::make_note(fifth, 4, result.root) != std::errc{})
+    return {first, std::errc::invalid_argument};
+
+  auto q = detail::find_quality({p, static_cast<std::size_t>(last - p)});
+  result.info = &detail::chord_db[q];
+  p += result.info->name.size();
+
+  auto add_tension = [&](const interval &iv) {
+    if (result.tension_count == chord_symbol::max_tensions)
+      return false;
+    result.tensions[result.tension_count++] = iv;
+    return true;
+  };
+  auto omit = [&](std::string_view token) {
+    bool found = false;
+    for (std::size_t j = 1; j < result.info->tone_count && j < 7; ++j) {
+      auto semi = result.info->interval_semitones[j];
+      if (detail::semitone_to_omission_name(semi) == token) {
+        result.omitted |= static_cast<std::uint16_t>(1u << semi);
+        found = true;
+      }
+    }
+    return found;
+  };
+
+  while (p != last) {
+    interval iv;
+    if (*p == '(') {
+      ++p;
+      while (true) {
+        std::string_view rest(p, static_cast<std::size_t>(last - p));
+        if (rest.starts_with("no")) {
+          auto end = p + 2;
+          while (end != last && *end >= '0' && *end <= '9')
+            ++end;
+          if (!omit({p, static_cast<std::size_t>(end - p)}))
+            return {first, std::errc::invalid_argument};
+          p = end;
+        } else if (auto end = detail::parse_tension(p, last, iv); end != p) {
+          if (!add_tension(iv))
+            return {first, std::errc::invalid_argument};
+          p = end;
+        } else {
+          return {first, std::errc::invalid_argument};
+        }
+        if (p != last && *p == ',') {
+          ++p;
+          continue;
+        }
+        if (p == last || *p != ')')
+          return {first, std::errc::invalid_argument};
+        ++p;
+        break;
+      }
+    } else if (auto end = detail::parse_tension(p, last, iv); end != p) {
+      if (!add_tension(iv))
+        return {first, std::errc::invalid_argument};
+      p = end;
+    } else {
+      break;
+    }
+  }
+
+  if (p != last && *p == '/') {
+    auto bass_end = detail::parse_pitch_name(p + 1, last, fifth);
+    note bass;
+    if (bass_end == p + 1 || detail::make_note(fifth, 4, bass) != std::errc{})
+      return {first, std::errc::invalid_argument};
+    while (bass.get_midi_pitch() >= result.root.get_midi_pitch())
+      bass = bass - intervals::P8;
+    while (bass.get_midi_pitch() + 12 < result.root.get_midi_pitch())
+      bass = bass + intervals::P8;
+    result.bass = bass;
+    p = bass_end;
+  }
+
+  value = result;
+  return {p, std::errc{}};
+}
+
+struct chord_symbol_batch {
+  std::size_t count{0};
+  const char *ptr{nullptr};
+  std::errc ec{};
+};
+
+constexpr chord_symbol_batch
+parse_chord_symbols(std::string_view text, std::span<chord_symbol> out) noexcept {
+  auto p = text.data();
+  auto last = text.data() + text.size();
+  std::size_t count = 0;
+  while (true) {
+    while (p != last && detail::is_symbol_separator(*p))
+      ++p;
+    if (p == last || count == out.size())
+      return {count, p, std::errc{}};
+    auto [end, ec] = from_chars(p, last, out[count]);
+    if (ec != std::errc{} || (end != last && !detail::is_symbol_separator(*end)))
+      return {count, p, std::errc::invalid_argument};
+    ++count;
+    p = end;
+  }
+}
+
+namespace literals {
+consteval chord_symbol operator""_chord(const char *text, std::size_t length) {
+  chord_symbol result;
+  auto [end, ec] = from_chars(text, text + length, result);
+  if (ec != std::errc{} || end != text + length)
+    throw "invalid chord symbol literal";
+  return result;
+}
+}
+
+}
+
+template <>
+struct std::formatter<musicpp::chord_symbol>
+    : musicpp::detail::text_formatter<musicpp::chord_symbol> {};
@@ -2,6 +2,8 @@
 #include "degree.hpp"
 #include "intervals.hpp"
 #include "notes.hpp"
+#include "pitch_class_set.hpp"
+#include "text.hpp"
 #include <algorithm>
 #include <array>
 #include <bit>
@@ -9,13 +11,21 @@
 #include <format>
 #include <numeric>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace musicpp {
 template <std::size_t N> struct slash_chord_instance;
 template <std::size_t S> struct scale_instance;
+struct compact_analysis;
+class chord_dictionary;
+
+namespace detail {
+struct chord_info;
+}
 
 template <std::size_t N> struct chord_pattern {
   std::array<interval, N> intervals;
@@ -63,6 +73,70 @@ template <std::size_t M>
   }
 };
 
+enum class omission : std::uint8_t {
+  none = 0,
+  no3 = 1u << 0,
+  no5 = 1u << 1,
+  no7 = 1u << 2,
+  no9 = 1u << 3,
+  no11 = 1u << 4,
+  no13 = 1u << 5,
+};
+
+[[nodiscard]] constexpr omission operator|(omission a, omission b) noexcept {
+  return static_cast<omission>(static_cast<std::uint8_t>(a) |
+                               static_cast<std::uint8_t>(b));
+}
+
+[[nodiscard]] constexpr omission operator&(omission a, omission b) noexcept {
+  return static_cast<omission>(static_cast<std::uint8_t>(a) &
+                               static_cast<std::uint8_t>(b));
+}
+
+[[nodiscard]] constexpr bool has(omission set, omission flag) noexcept {
+  return (set & flag) != omission::none;
+}
+
+struct chord_name {
+  static constexpr std::size_t max_size = 47;
+
+  std::array<char, max_size + 1> chars{};
+  std::size_t length{0};
+
+  constexpr void append(char c) noexcept {
+    if (length < max_size)
+      chars[length++] = c;
+  }
+
+  constexpr void append(std::string_view s) noexcept {
+    for (char c : s)
+      append(c);
+  }
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept { return length; }
+  [[nodiscard]] constexpr bool empty() const noexcept { return length == 0; }
+  [[nodiscard]] constexpr const char *data() const noexcept {
+    return chars.data();
+  }
+  [[nodiscard]] constexpr std::string_view view() const noexcept {
+    return {chars.data(), length};
+  }
+  [[nodiscard]] std::string str() const { return std::string(view()); }
+
+  [[nodiscard]] friend constexpr bool operator==(const chord_name &a,
+                                                 std::string_view b) noexcept {
+    return a.view() == b;
+  }
+  [[nodiscard]] friend constexpr bool operator==(const chord_name &a,
+                                                 const chord_name &b) noexcept {
+    return a.view() == b.view();
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const chord_name &n) {
+    return os << n.view();
+  }
+};
+
 struct chord_analysis {
   note root;
   std::string quality;
@@ -70,24 +144,29 @@ struct chord_analysis {
   std::int8_t inversion{0};
   std::vector<std::string> omissions;
 
-  [[nodiscard]] std::string str() const {
-    auto result = root.simplify().pitch_name() + quality;
+  bool operator==(const chord_analysis &) const = default;
+
+  template <typename Out> Out write_to(Out out) const {
+    out = root.simplify().write_pitch_name(out);
+    out = detail::write_chars(out, quality);
     if (!omissions.empty()) {
-      result += "(";
+      *out++ = '(';
       for (std::size_t i = 0; i < omissions.size(); ++i) {
         if (i > 0)
-          result += ",";
-        result += omissions[i];
+          *out++ = ',';
+        out = detail::write_chars(out, omissions[i]);
       }
-      result += ")";
+      *out++ = ')';
     }
     if (bass) {
-      result += "/";
-      result += bass->simplify().pitch_name();
+      *out++ = '/';
+      out = bass->simplify().write_pitch_name(out);
     }
-    return result;
+    return out;
   }
 
+  [[nodiscard]] std::string str() const { return detail::to_text(*this); }
+
   friend std::ostream &operator<<(std::ostream &os, const chord_analysis &a) {
     return os << a.str();
   }
@@ -106,18 +185,16 @@ struct analysis_result {
   [[nodiscard]] auto begin() const noexcept { return interpretations.begin(); }
   [[nodiscard]] auto end() const noexcept { return interpretations.end(); }
 
-  [[nodiscard]] std::string str() const {
+  bool operator==(const analysis_result &) const = default;
+
+  template <typename Out> Out write_to(Out out) const {
     if (interpretations.empty())
-      return "?";
-    std::string result;
-    for (std::size_t i = 0; i < interpretations.size(); ++i) {
-      if (i > 0)
-        result += " | ";
-      result += interpretations[i].str();
-    }
-    return result;
+      return detail::write_chars(out, "?");
+    return detail::write_joined(out, interpretations, " | ");
   }
 
+  [[nodiscard]] std::string str() const { return detail::to_text(*this); }
+
   friend std::ostream &operator<<(std::ostream &os, const analysis_result &r) {
     return os << r.str();
   }
@@ -150,6 +227,10 @@ template <std::size_t N> struct chord_instance {
     return *std::ranges::max_element(notes, {}, &note::get_midi_pitch);
   }
 
+  [[nodiscard]] constexpr pitch_class_set pitch_classes() const noexcept {
+    return pitch_class_set(std::span<const note>(notes));
+  }
+
   [[nodiscard]] constexpr bool contains(const note &target) const noexcept {
     return std::ranges::any_of(notes,
                                [&](const note &n) { return n == target; });
@@ -178,8 +259,19 @@ template <std::size_t N> struct chord_instance {
   [[nodiscard]] auto analyze(const scale_instance<S> &key) const;
   template <std::size_t S>
   [[nodiscard]] auto analyze(const scale_instance<S> &key, const note &root) const;
+  [[nodiscard]] constexpr auto analyze_compact() const;
+  [[nodiscard]] constexpr std::optional<compact_analysis>
+  analyze_compact(const note &root) const;
+  [[nodiscard]] consteval auto analyze_ct() const;
+  [[nodiscard]] analysis_result analyze(const chord_dictionary &dict) const;
+  template <std::size_t Capacity = std::dynamic_extent>
+  [[nodiscard]] auto analyze_compact(const chord_dictionary &dict) const;
   [[nodiscard]] constexpr auto operator/(const note &bass) const;
 
+  template <typename Out> constexpr Out write_to(Out out) const {
+    return detail::write_joined(out, notes, " ");
+  }
+
   friend std::ostream &operator<<(std::ostream &os, const chord_instance &c) {
     for (std::size_t i = 0; i < N; ++i) {
       if (i > 0)
@@ -241,6 +333,12 @@ template <std::size_t N> struct slash_chord_instance {
   template <std::size_t S>
   [[nodiscard]] auto analyze(const scale_instance<S> &key, const note &root) const;
 
+  template <typename Out> constexpr Out write_to(Out out) const {
+    out = chord.write_to(out);
+    *out++ = '/';
+    return bass.write_to(out);
+  }
+
   friend std::ostream &operator<<(std::ostream &os,
                                   const slash_chord_instance &sc) {
     os << sc.chord << '/' << sc.bass;
@@ -270,24 +368,31 @@ struct chord_info {
   std::uint16_t pitch_class_set;
   std::uint8_t tone_count;
   std::array<std::int8_t, 7> interval_semitones;
+  std::array<interval, 7> intervals;
 };
 
+// Quality of a default-constructed analysis, so callers never test for null.
+inline constexpr chord_info no_chord_info{};
+
 template <std::size_t N>
-consteval chord_info make_chord_info(std::string_view name,
+constexpr chord_info make_chord_info(std::string_view name,
                                      const chord_pattern<N> &pattern) {
   std::uint16_t pcs = 0;
   std::array<std::int8_t, 7> semis{};
+  std::array<interval, 7> ivs{};
   semis.fill(-1);
   for (std::size_t i = 0; i < N; ++i) {
     int s = ((pattern.intervals[i].fifths * 7) % 12 + 12) % 12;
     pcs |= static_cast<std::uint16_t>(1u << s);
-    if (i < 7)
+    if (i < 7) {
       semis[i] = static_cast<std::int8_t>(s);
+      ivs[i] = pattern.intervals[i];
+    }
   }
-  return {name, pcs, static_cast<std::uint8_t>(N), semis};
+  return {name, pcs, static_cast<std::uint8_t>(N), semis, ivs};
 }
 
-inline std::string semitone_to_omission_name(std::int8_t semi) {
+constexpr std::string_view semitone_to_omission_name(std::int8_t semi) noexcept {
   switch (semi) {
   case 1: case 2: return "no9";
   case 3: case 4: return "no3";
@@ -299,7 +404,19 @@ inline std::string semitone_to_omission_name(std::int8_t semi) {
   }
 }
 
-inline std::int8_t detect_inversion(std::int8_t bass_semi, const chord_info &info) {
+constexpr omission semitone_to_omission(std::int8_t semi) noexcept {
+  switch (semi) {
+  case 1: case 2: return omission::no9;
+  case 3: case 4: return omission::no3;
+  case 5:         return omission::no11;
+  case 6: case 7: return omission::no5;
+  case 8: case 9: return omission::no13;
+  case 10: case 11: return omission::no7;
+  default:        return omission::none;
+  }
+}
+
+constexpr std::int8_t detect_inversion(std::int8_t bass_semi, const chord_info &info) {
   for (std::int8_t i = 1; i < info.tone_count && i < 7; ++i) {
     if (info.interval_semitones[i] == bass_semi)
       return i;
@@ -471,125 +588,388 @@ inline constexpr auto chord_db = std::to_array<chord_info>({
     make_chord_info("5", chord_patterns::power_chord),
 });
 
-struct match_result {
-  const chord_info *info;
-  std::vector<std::string> omissions;
+struct pcs_match {
+  std::uint16_t chord;
+  std::uint16_t omitted;
+};
+
+struct pcs_slot {
+  std::uint32_t first;
+  std::uint32_t count;
 };
 
-inline std::vector<match_result>
-find_matches(std::uint16_t input_pcs, std::size_t input_count) {
-  std::vector<match_result> results;
+constexpr bool names_all_omissions(const chord_info &info,
+                                   std::uint16_t omitted) {
+  int named = 0;
+  for (std::int8_t j = 0; j < info.tone_count && j < 7; ++j) {
+    auto semi = info.interval_semitones[j];
+    if (semi >= 0 && (omitted & (1u << semi)))
+      ++named;
+  }
+  return named == std::popcount(omitted);
+}
 
-  for (const auto &info : chord_db) {
-    if (input_pcs == info.pitch_class_set) {
-      results.push_back({&info, {}});
+template <typename F>
+constexpr void for_each_omission(const chord_info &info, F &&f) {
+  auto set = info.pitch_class_set;
+  for (int a = 1; a < 12; ++a) {
+    if (!(set & (1u << a)))
+      continue;
+    auto one = static_cast<std::uint16_t>(1u << a);
+    if (info.tone_count > std::popcount(static_cast<std::uint16_t>(set & ~one)) &&
+        names_all_omissions(info, one))
+      f(static_cast<std::uint16_t>(set & ~one), one);
+    for (int b = a + 1; b < 12; ++b) {
+      if (!(set & (1u << b)))
+        continue;
+      auto two = static_cast<std::uint16_t>(one | (1u << b));
+      if (info.tone_count > std::popcount(static_cast<std::uint16_t>(set & ~two)) &&
+          names_all_omissions(info, two))
+        f(static_cast<std::uint16_t>(set & ~two), two);
     }
   }
-  if (!results.empty())
-    return results;
+}
 
-  if (!(input_pcs & 1u))
-    return results;
+template <typename F>
+constexpr void for_each_pcs_match(std::span<const chord_info> infos,
+                                  const std::array<bool, 4096> &exact, F &&f) {
+  for (std::size_t i = 0; i < infos.size(); ++i) {
+    f(infos[i].pitch_class_set, i, std::uint16_t{0});
+    for_each_omission(infos[i], [&](std::uint16_t set, std::uint16_t omitted) {
+      if (!exact[set])
+        f(set, i, omitted);
+    });
+  }
+}
 
-  for (const auto &info : chord_db) {
-    if (info.tone_count <= input_count)
-      continue;
-    if ((input_pcs & info.pitch_class_set) != input_pcs)
-      continue;
+constexpr std::array<bool, 4096>
+exact_pitch_class_sets(std::span<const chord_info> infos) {
+  std::array<bool, 4096> exact{};
+  for (const auto &info : infos)
+    exact[info.pitch_class_set] = true;
+  return exact;
+}
 
-    auto omitted_bits = static_cast<std::uint16_t>(info.pitch_class_set & ~input_pcs);
-    int omitted_count = std::popcount(omitted_bits);
-    if (omitted_count > 2)
-      continue;
+constexpr std::size_t count_pcs_matches(std::span<const chord_info> infos) {
+  std::size_t n = 0;
+  for_each_pcs_match(infos, exact_pitch_class_sets(infos),
+                     [&](std::uint16_t, std::size_t, std::uint16_t) { ++n; });
+  return n;
+}
 
-    if (omitted_bits & 1u)
-      continue;
+template <typename Slots, typename Matches>
+constexpr void fill_pcs_table(std::span<const chord_info> infos, Slots &slots,
+                              Matches &matches) {
+  auto exact = exact_pitch_class_sets(infos);
+  for_each_pcs_match(infos, exact, [&](std::uint16_t set, std::size_t, std::uint16_t) {
+    ++slots[set].count;
+  });
+  std::uint32_t first = 0;
+  for (auto &slot : slots) {
+    slot.first = first;
+    first += slot.count;
+    slot.count = 0;
+  }
+  for_each_pcs_match(infos, exact, [&](std::uint16_t set, std::size_t i,
+                                       std::uint16_t omitted) {
+    auto &slot = slots[set];
+    matches[slot.first + slot.count++] = {static_cast<std::uint16_t>(i), omitted};
+  });
+}
 
-    std::vector<std::string> omissions;
-    for (std::int8_t j = 0; j < info.tone_count && j < 7; ++j) {
-      auto semi = info.interval_semitones[j];
-      if (semi >= 0 && (omitted_bits & (1u << semi))) {
-        omissions.push_back(semitone_to_omission_name(semi));
-      }
-    }
+template <std::size_t M> struct pcs_table {
+  std::array<pcs_slot, 4096> slots;
+  std::array<pcs_match, M> matches;
 
-    if (static_cast<int>(omissions.size()) == omitted_count) {
-      results.push_back({&info, std::move(omissions)});
-    }
+  [[nodiscard]] constexpr std::span<const pcs_match>
+  operator[](std::uint16_t set) const noexcept {
+    auto slot = slots[set & 0xfffu];
+    return {matches.data() + slot.first, slot.count};
   }
-  return results;
+};
+
+template <std::size_t M> consteval pcs_table<M> make_pcs_table() {
+  pcs_table<M> table{};
+  fill_pcs_table(chord_db, table.slots, table.matches);
+  return table;
 }
 
-inline chord_analysis build_analysis(const note &root_note, const match_result &match,
-                                     const note &lowest) {
-  auto root_pitch = root_note.get_pitch();
-  std::optional<note> bass_note;
-  std::int8_t inv = 0;
+inline constexpr auto pcs_lookup = make_pcs_table<count_pcs_matches(chord_db)>();
 
-  if (root_pitch != lowest.get_pitch()) {
-    bass_note = lowest;
-    auto bass_semi = static_cast<std::int8_t>((lowest.get_pitch() - root_pitch + 12) % 12);
-    inv = detect_inversion(bass_semi, *match.info);
+struct match_table {
+  const pcs_slot *slots;
+  const pcs_match *matches;
+  const chord_info *infos;
+
+  [[nodiscard]] constexpr std::span<const pcs_match>
+  operator[](std::uint16_t set) const noexcept {
+    auto slot = slots[set & 0xfffu];
+    return {matches + slot.first, slot.count};
+  }
+
+  [[nodiscard]] constexpr const chord_info &
+  info(const pcs_match &match) const noexcept {
+    return infos[match.chord];
   }
+};
 
-  return {root_note.simplify(), std::string(match.info->name),
-          bass_note, inv, match.omissions};
+inline constexpr match_table builtin_matches{
+    pcs_lookup.slots.data(), pcs_lookup.matches.data(), chord_db.data()};
+
+[[nodiscard]] constexpr std::span<const pcs_match>
+find_matches(std::uint16_t input_pcs) noexcept {
+  return pcs_lookup[input_pcs];
 }
 
-template <std::size_t M>
-[[nodiscard]] inline analysis_result
-analyze_all(const std::array<note, M> &notes) {
-  auto build_pcs = [&](std::int8_t root_pitch) -> std::uint16_t {
-    std::uint16_t set = 0;
-    for (std::size_t i = 0; i < M; ++i) {
-      int rel = (notes[i].get_pitch() - root_pitch + 12) % 12;
-      set |= static_cast<std::uint16_t>(1u << rel);
+constexpr std::size_t count_max_interpretations(const match_table &table) {
+  std::size_t most = 0;
+  for (unsigned set = 1; set < 4096; ++set) {
+    std::size_t n = 0;
+    for (int root = 0; root < 12; ++root) {
+      if (set & (1u << root))
+        n += table[rotate_pcs(static_cast<std::uint16_t>(set), root)].size();
     }
-    return set;
-  };
+    most = std::max(most, n);
+  }
+  return most;
+}
 
-  std::array<std::size_t, M> order;
-  std::iota(order.begin(), order.end(), 0);
-  std::ranges::sort(order, [&](std::size_t a, std::size_t b) {
-    return notes[a].get_midi_pitch() < notes[b].get_midi_pitch();
-  });
+inline constexpr std::size_t max_interpretations =
+    count_max_interpretations(builtin_matches);
+
+constexpr void append_pitch_name(chord_name &out, const note &n) noexcept {
+  constexpr std::string_view letters = "FCGDAEB";
+  int shifted = n.get_fifth() + 1;
+  int accidentals = (shifted >= 0) ? shifted / 7 : (shifted - 6) / 7;
+  out.append(letters[static_cast<std::size_t>(((shifted % 7) + 7) % 7)]);
+  for (int i = 0; i < accidentals; ++i)
+    out.append('#');
+  for (int i = 0; i > accidentals; --i)
+    out.append('b');
+}
 
-  analysis_result result;
-  auto lowest = notes[order[0]];
-  std::uint16_t tried = 0;
+inline std::vector<std::string> omission_names(const chord_info &info,
+                                               std::uint16_t omitted) {
+  std::vector<std::string> omissions;
+  for (std::int8_t j = 0; j < info.tone_count && j < 7; ++j) {
+    auto semi = info.interval_semitones[j];
+    if (semi >= 0 && (omitted & (1u << semi)))
+      omissions.emplace_back(semitone_to_omission_name(semi));
+  }
+  return omissions;
+}
+}
 
-  auto input_count = static_cast<std::size_t>(
-      std::popcount(build_pcs(notes[order[0]].get_pitch())));
+struct compact_analysis {
+  note root;
+  std::optional<note> bass;
+  std::int8_t inversion{0};
+  std::uint16_t omitted{0};
+  const detail::chord_info *info{&detail::no_chord_info};
 
-  for (std::size_t idx : order) {
-    auto pc = notes[idx].get_pitch();
-    if (tried & (1u << pc))
-      continue;
-    tried |= static_cast<std::uint16_t>(1u << pc);
+  [[nodiscard]] constexpr std::string_view quality() const noexcept {
+    return info->name;
+  }
 
-    auto pcs_val = build_pcs(pc);
-    auto matches = find_matches(pcs_val, input_count);
-    for (const auto &m : matches) {
-      result.interpretations.push_back(
-          build_analysis(notes[idx], m, lowest));
+  [[nodiscard]] constexpr omission omissions() const noexcept {
+    auto flags = omission::none;
+    for (std::int8_t semi = 1; semi < 12; ++semi) {
+      if (omitted & (1u << semi))
+        flags = flags | detail::semitone_to_omission(semi);
     }
+    return flags;
   }
 
-  std::ranges::stable_sort(result.interpretations,
-    [](const chord_analysis &a, const chord_analysis &b) {
-      if (a.omissions.size() != b.omissions.size())
-        return a.omissions.size() < b.omissions.size();
-      if (a.inversion != b.inversion)
-        return a.inversion < b.inversion;
-      return a.quality.size() < b.quality.size();
-    });
+  [[nodiscard]] constexpr std::size_t omission_count() const noexcept {
+    return static_cast<std::size_t>(std::popcount(omitted));
+  }
 
+  constexpr bool operator==(const compact_analysis &) const noexcept = default;
+
+  [[nodiscard]] constexpr chord_name name() const noexcept {
+    chord_name result;
+    detail::append_pitch_name(result, root.simplify());
+    result.append(quality());
+    if (omitted) {
+      result.append('(');
+      bool first = true;
+      for (std::int8_t j = 0; j < info->tone_count && j < 7; ++j) {
+        auto semi = info->interval_semitones[j];
+        if (semi < 0 || !(omitted & (1u << semi)))
+          continue;
+        if (!first)
+          result.append(',');
+        result.append(detail::semitone_to_omission_name(semi));
+        first = false;
+      }
+      result.append(')');
+    }
+    if (bass) {
+      result.append('/');
+      detail::append_pitch_name(result, bass->simplify());
+    }
+    return result;
+  }
+
+  [[nodiscard]] chord_analysis expand() const {
+    return {root, std::string(quality()), bass, inversion,
+            detail::omission_names(*info, omitted)};
+  }
+
+  template <typename Out> constexpr Out write_to(Out out) const {
+    return detail::write_chars(out, name().view());
+  }
+
+  [[nodiscard]] std::string str() const { return detail::to_text(*this); }
+
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const compact_analysis &a) {
+    return os << a.str();
+  }
+};
+
+namespace detail {
+[[nodiscard]] constexpr bool ranks_before(const compact_analysis &a,
+                                          const compact_analysis &b) noexcept {
+  if (a.omission_count() != b.omission_count())
+    return a.omission_count() < b.omission_count();
+  if (a.inversion != b.inversion)
+    return a.inversion < b.inversion;
+  return a.quality().size() < b.quality().size();
+}
+}
+
+// The best `Capacity` interpretations, ranked. With std::dynamic_extent the
+// capacity is set once at construction (for a chord_dictionary, its
+// max_interpretations()), so insert still never allocates.
+template <std::size_t Capacity = detail::max_interpretations>
+struct compact_analysis_result {
+  static constexpr bool is_dynamic = Capacity == std::dynamic_extent;
+
+  std::conditional_t<is_dynamic, std::vector<compact_analysis>,
+                     std::array<compact_analysis, Capacity>>
+      interpretations{};
+  std::size_t count{0};
+
+  constexpr compact_analysis_result() noexcept
+    requires(!is_dynamic)
+  = default;
+  explicit compact_analysis_result(std::size_t capacity)
+    requires is_dynamic
+      : interpretations(capacity) {}
+
+  [[nodiscard]] constexpr std::size_t capacity() const noexcept {
+    return interpretations.size();
+  }
+  [[nodiscard]] constexpr bool empty() const noexcept { return count == 0; }
+  [[nodiscard]] constexpr std::size_t size() const noexcept { return count; }
+  [[nodiscard]] constexpr const compact_analysis &
+  operator[](std::size_t i) const noexcept {
+    return interpretations[i];
+  }
+  [[nodiscard]] constexpr auto begin() const noexcept {
+    return interpretations.begin();
+  }
+  [[nodiscard]] constexpr auto end() const noexcept {
+    return interpretations.begin() + static_cast<std::ptrdiff_t>(count);
+  }
+
+  constexpr void clear() noexcept { count = 0; }
+
+  constexpr void insert(const compact_analysis &a) noexcept {
+    const auto cap = capacity();
+    auto pos = count;
+    while (pos > 0 && detail::ranks_before(a, interpretations[pos - 1]))
+      --pos;
+    if (pos >= cap)
+      return;
+    auto last = count < cap ? count : cap - 1;
+    for (auto i = last; i > pos; --i)
+      interpretations[i] = interpretations[i - 1];
+    interpretations[pos] = a;
+    if (count < cap)
+      ++count;
+  }
+
+  [[nodiscard]] analysis_result expand() const {
+    analysis_result result;
+    result.interpretations.reserve(count);
+    for (const auto &a : *this)
+      result.interpretations.push_back(a.expand());
+    return result;
+  }
+
+  template <typename Out> constexpr Out write_to(Out out) const {
+    if (empty())
+      return detail::write_chars(out, "?");
+    return detail::write_joined(out, *this, " | ");
+  }
+
+  [[nodiscard]] std::string str() const { return detail::to_text(*this); }
+
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const compact_analysis_result &r) {
+    return os << r.str();
+  }
+};
+
+namespace detail {
+[[nodiscard]] constexpr compact_analysis
+build_analysis(const note &root_note, const pcs_match &match,
+               const chord_info &info, const note &lowest) noexcept {
+  compact_analysis result{root_note.simplify(), std::nullopt, 0,
+                          match.omitted, &info};
+  auto root_pitch = root_note.get_pitch();
+  if (root_pitch != lowest.get_pitch()) {
+    result.bass = lowest;
+    auto bass_semi = static_cast<std::int8_t>((lowest.get_pitch() - root_pitch + 12) % 12);
+    result.inversion = detect_inversion(bass_semi, info);
+  }
   return result;
 }
 
+template <std::size_t M, typename Result>
+constexpr void analyze_compact(const std::array<note, M> &notes, Result &result,
+                               const match_table &table = builtin_matches) noexcept {
+  std::array<std::size_t, 12> lowest_of{};
+  std::uint16_t present = 0;
+  std::size_t lowest = 0;
+  for (std::size_t i = 0; i < M; ++i) {
+    auto pc = notes[i].get_pitch();
+    auto midi = notes[i].get_midi_pitch();
+    if (!(present & (1u << pc)) || midi < notes[lowest_of[pc]].get_midi_pitch())
+      lowest_of[pc] = i;
+    present |= static_cast<std::uint16_t>(1u << pc);
+    if (midi < notes[lowest].get_midi_pitch())
+      lowest = i;
+  }
+
+  std::array<std::size_t, 12> roots{};
+  std::size_t root_count = 0;
+  for (int pc = 0; pc < 12; ++pc) {
+    if (!(present & (1u << pc)))
+      continue;
+    auto idx = lowest_of[pc];
+    auto pos = root_count++;
+    while (pos > 0 && notes[roots[pos - 1]].get_midi_pitch() >
+                          notes[idx].get_midi_pitch()) {
+      roots[pos] = roots[pos - 1];
+      --pos;
+    }
+    roots[pos] = idx;
+  }
+
+  for (std::size_t k = 0; k < root_count; ++k) {
+    const auto &root = notes[roots[k]];
+    for (const auto &m : table[rotate_pcs(present, root.get_pitch())])
+      result.insert(build_analysis(root, m, table.info(m), notes[lowest]));
+  }
+}
+
 template <std::size_t M>
-[[nodiscard]] inline std::optional<chord_analysis>
-analyze_with_root(const std::array<note, M> &notes, const note &root) {
+[[nodiscard]] constexpr std::optional<compact_analysis>
+analyze_compact_with_root(const std::array<note, M> &notes, const note &root,
+                          const match_table &table = builtin_matches) noexcept {
   std::uint16_t set = 0;
   auto root_pitch = root.get_pitch();
   for (std::size_t i = 0; i < M; ++i) {
@@ -597,13 +977,46 @@ analyze_with_root(const std::array<note, M> &notes, const note &root) {
     set |= static_cast<std::uint16_t>(1u << rel);
   }
   auto lowest = *std::ranges::min_element(notes, {}, &note::get_midi_pitch);
-  auto input_count = static_cast<std::size_t>(std::popcount(set));
-  auto matches = find_matches(set, input_count);
+  auto matches = table[set];
   if (!matches.empty()) {
-    return build_analysis(root, matches[0], lowest);
+    return build_analysis(root, matches[0], table.info(matches[0]), lowest);
   }
   return std::nullopt;
 }
+
+template <std::size_t M>
+[[nodiscard]] inline analysis_result
+analyze_all(const std::array<note, M> &notes) {
+  compact_analysis_result<> result;
+  analyze_compact(notes, result);
+  return result.expand();
+}
+
+template <std::size_t M>
+[[nodiscard]] inline std::optional<chord_analysis>
+analyze_with_root(const std::array<note, M> &notes, const note &root) {
+  if (auto a = analyze_compact_with_root(notes, root))
+    return a->expand();
+  return std::nullopt;
+}
+}
+
+template <std::size_t N>
+[[nodiscard]] constexpr auto chord_instance<N>::analyze_compact() const {
+  compact_analysis_result<> result;
+  detail::analyze_compact(notes, result);
+  return result;
+}
+
+template <std::size_t N>
+[[nodiscard]] constexpr std::optional<compact_analysis>
+chord_instance<N>::analyze_compact(const note &root) const {
+  return detail::analyze_compact_with_root(notes, root);
+}
+
+template <std::size_t N>
+[[nodiscard]] consteval auto chord_instance<N>::analyze_ct() const {
+  return analyze_compact();
 }
 
 
@@ -612,6 +1025,12 @@ struct degree_analysis {
   degree deg;
   std::string roman_numeral;
 
+  bool operator==(const degree_analysis &) const = default;
+
+  template <typename Out> Out write_to(Out out) const {
+    return detail::write_chars(out, roman_numeral);
+  }
+
   [[nodiscard]] std::string str() const { return roman_numeral; }
 
   friend std::ostream &operator<<(std::ostream &os, const degree_analysis &d) {
@@ -632,18 +1051,16 @@ struct key_analysis_result {
   [[nodiscard]] auto begin() const noexcept { return interpretations.begin(); }
   [[nodiscard]] auto end() const noexcept { return interpretations.end(); }
 
-  [[nodiscard]] std::string str() const {
+  bool operator==(const key_analysis_result &) const = default;
+
+  template <typename Out> Out write_to(Out out) const {
     if (interpretations.empty())
-      return "?";
-    std::string result;
-    for (std::size_t i = 0; i < interpretations.size(); ++i) {
-      if (i > 0)
-        result += " | ";
-      result += interpretations[i].str();
-    }
-    return result;
+      return detail::write_chars(out, "?");
+    return detail::write_joined(out, interpretations, " | ");
   }
 
+  [[nodiscard]] std::string str() const { return detail::to_text(*this); }
+
   friend std::ostream &operator<<(std::ostream &os,
                                   const key_analysis_result &r) {
     return os << r.str();
@@ -828,61 +1245,32 @@ slash_chord_instance<N>::analyze(const scale_instance<S> &key,
 }
 
 template <>
-struct std::formatter<musicpp::chord_analysis> : std::formatter<std::string> {
-  auto format(const musicpp::chord_analysis &a, auto &ctx) const {
-    return std::formatter<std::string>::format(a.str(), ctx);
+struct std::formatter<musicpp::chord_name> : std::formatter<std::string_view> {
+  auto format(const musicpp::chord_name &n, auto &ctx) const {
+    return std::formatter<std::string_view>::format(n.view(), ctx);
   }
 };
 
 template <>
-struct std::formatter<musicpp::analysis_result> : std::formatter<std::string> {
-  auto format(const musicpp::analysis_result &r, auto &ctx) const {
-    return std::formatter<std::string>::format(r.str(), ctx);
-  }
-};
+struct std::formatter<musicpp::chord_analysis>
+    : musicpp::detail::text_formatter<musicpp::chord_analysis> {};
+
+template <>
+struct std::formatter<musicpp::analysis_result>
+    : musicpp::detail::text_formatter<musicpp::analysis_result> {};
 
 template <std::size_t N>
 struct std::formatter<musicpp::chord_instance<N>>
-    : std::formatter<std::string> {
-  auto format(const musicpp::chord_instance<N> &c, auto &ctx) const {
-    std::string s;
-    for (std::size_t i = 0; i < N; ++i) {
-      if (i > 0)
-        s += ' ';
-      s += c[i].str();
-    }
-    return std::formatter<std::string>::format(s, ctx);
-  }
-};
+    : musicpp::detail::text_formatter<musicpp::chord_instance<N>> {};
 
 template <std::size_t N>
 struct std::formatter<musicpp::slash_chord_instance<N>>
-    : std::formatter<std::string> {
-  auto format(const musicpp::slash_chord_instance<N> &sc, auto &ctx) const {
-    std::string s;
-    for (std::size_t i = 0; i < N; ++i) {
-      if (i > 0)
-        s += ' ';
-      s += sc[i].str();
-    }
-    s += '/';
-    s += sc.bass.str();
-    return std::formatter<std::string>::format(s, ctx);
-  }
-};
+    : musicpp::detail::text_formatter<musicpp::slash_chord_instance<N>> {};
 
 template <>
 struct std::formatter<musicpp::degree_analysis>
-    : std::formatter<std::string> {
-  auto format(const musicpp::degree_analysis &d, auto &ctx) const {
-    return std::formatter<std::string>::format(d.str(), ctx);
-  }
-};
+    : musicpp::detail::text_formatter<musicpp::degree_analysis> {};
 
 template <>
 struct std::formatter<musicpp::key_analysis_result>
-    : std::formatter<std::string> {
-  auto format(const musicpp::key_analysis_result &r, auto &ctx) const {
-    return std::formatter<std::string>::format(r.str(), ctx);
-  }
-};
\ No newline at end of file
+    : musicpp::detail::text_formatter<musicpp::key_analysis_result> {};
@@ -1,12 +1,66 @@
 #pragma once
+#include "text.hpp"
+#include <cstddef>
+#include <array>
+#include <compare>
 #include <cstdint>
 #include <format>
 #include <numeric>
 #include <ostream>
 #include <string>
+#include <string_view>
 
 namespace musicpp {
 
+namespace detail {
+inline constexpr std::int64_t max_wide_den = std::int64_t{1} << 40;
+
+// Unsigned 128-bit value, enough for a wide_duration numerator times a
+// denominator (2^63 * 2^40) when comparing or dividing exactly.
+struct uint128 {
+  std::uint64_t hi{0};
+  std::uint64_t lo{0};
+
+  constexpr auto operator<=>(const uint128 &) const noexcept = default;
+};
+
+[[nodiscard]] constexpr std::uint64_t magnitude(std::int64_t x) noexcept {
+  return x < 0 ? 0u - static_cast<std::uint64_t>(x) : static_cast<std::uint64_t>(x);
+}
+
+[[nodiscard]] constexpr uint128 multiply(std::uint64_t a, std::uint64_t b) noexcept {
+  constexpr std::uint64_t low = 0xffffffffu;
+  const auto p00 = (a & low) * (b & low);
+  const auto p01 = (a & low) * (b >> 32);
+  const auto p10 = (a >> 32) * (b & low);
+  const auto p11 = (a >> 32) * (b >> 32);
+  const auto mid = (p00 >> 32) + (p01 & low) + (p10 & low);
+  return {p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32), (mid << 32) | (p00 & low)};
+}
+
+// n / d rounded down (its low 64 bits if wider); `exact` reports whether
+// nothing was left over. Values that fit 64 bits take one hardware divide.
+[[nodiscard]] constexpr std::uint64_t divide(uint128 n, uint128 d,
+                                             bool &exact) noexcept {
+  if (n.hi == 0 && d.hi == 0) {
+    exact = n.lo % d.lo == 0;
+    return n.lo / d.lo;
+  }
+  uint128 r{};
+  std::uint64_t q = 0;
+  for (int i = 127; i >= 0; --i) {
+    auto bit = (i >= 64 ? n.hi >> (i - 64) : n.lo >> i) & 1u;
+    r = {r.hi << 1 | r.lo >> 63, r.lo << 1 | bit};
+    q <<= 1;
+    if (!(r < d)) {
+      r = {r.hi - d.hi - (r.lo < d.lo ? 1u : 0u), r.lo - d.lo};
+      q |= 1;
+    }
+  }
+  exact = r == uint128{};
+  return q;
+}
+}
 
 struct duration {
   std::int16_t num{1};
@@ -59,29 +113,217 @@ struct duration {
     return static_cast<double>(num * beat_den) / den;
   }
 
-  [[nodiscard]] constexpr std::string str() const {
+  static constexpr std::size_t max_chars = 16;
+
+  template <typename Out> constexpr Out write_to(Out out) const {
     if (num == 1) {
       switch (den) {
-      case 1:  return "w";
-      case 2:  return "h";
-      case 4:  return "q";
-      case 8:  return "8th";
-      case 16: return "16th";
-      case 32: return "32nd";
+      case 1:  return detail::write_chars(out, "w");
+      case 2:  return detail::write_chars(out, "h");
+      case 4:  return detail::write_chars(out, "q");
+      case 8:  return detail::write_chars(out, "8th");
+      case 16: return detail::write_chars(out, "16th");
+      case 32: return detail::write_chars(out, "32nd");
       }
     }
-    if (num == 3 && den == 2) return "w.";
-    if (num == 3 && den == 4) return "h.";
-    if (num == 3 && den == 8) return "q.";
-    if (num == 3 && den == 16) return "8th.";
-    return std::to_string(num) + "/" + std::to_string(den);
+    if (num == 3 && den == 2) return detail::write_chars(out, "w.");
+    if (num == 3 && den == 4) return detail::write_chars(out, "h.");
+    if (num == 3 && den == 8) return detail::write_chars(out, "q.");
+    if (num == 3 && den == 16) return detail::write_chars(out, "8th.");
+    out = detail::write_int(out, num);
+    *out++ = '/';
+    return detail::write_int(out, den);
+  }
+
+  [[nodiscard]] constexpr std::string str() const {
+    return detail::to_text<duration, max_chars>(*this);
   }
 
   friend std::ostream &operator<<(std::ostream &os, const duration &d) {
-    return os << d.str();
+    std::array<char, max_chars> buffer{};
+    return os << std::string_view(buffer.data(), d.write_to(buffer.data()));
+  }
+};
+
+// 64-bit rational for sums over long pieces. The denominator only grows
+// (to the lcm of the parts) and is left unreduced while accumulating, so
+// the common case of adding a duration whose denominator divides it costs
+// one divide and one multiply-add, with no gcd.
+struct wide_duration {
+  std::int64_t num{0};
+  std::int64_t den{1};
+
+  constexpr wide_duration() noexcept = default;
+  constexpr wide_duration(duration d) noexcept : num(d.num), den(d.den) {}
+  constexpr wide_duration(std::int64_t n, std::int64_t d) noexcept {
+    if (d < 0) { n = -n; d = -d; }
+    auto g = std::gcd(n < 0 ? -n : n, d);
+    num = g > 1 ? n / g : n;
+    den = g > 1 ? d / g : d;
+  }
+
+  constexpr wide_duration &operator+=(wide_duration other) {
+    if (den % other.den == 0) {
+      num += other.num * (den / other.den);
+      return *this;
+    }
+    auto scale = other.den / std::gcd(den, other.den);
+    if (den > detail::max_wide_den / scale)
+      throw "duration denominator overflow";
+    num = num * scale + other.num * (den * scale / other.den);
+    den *= scale;
+    return *this;
+  }
+  constexpr wide_duration &operator-=(wide_duration other) {
+    return *this += wide_duration{-other.num, other.den};
+  }
+
+  [[nodiscard]] friend constexpr wide_duration
+  operator+(wide_duration a, wide_duration b) {
+    return a += b;
+  }
+  [[nodiscard]] friend constexpr wide_duration
+  operator-(wide_duration a, wide_duration b) {
+    return a -= b;
+  }
+  [[nodiscard]] friend constexpr wide_duration
+  operator*(wide_duration d, std::int64_t n) noexcept {
+    d.num *= n;
+    return d;
+  }
+
+  // Cross products are formed in 128 bits, so operands near max_wide_den
+  // compare exactly.
+  [[nodiscard]] friend constexpr bool
+  operator==(wide_duration a, wide_duration b) noexcept {
+    return (a <=> b) == 0;
+  }
+  [[nodiscard]] friend constexpr std::strong_ordering
+  operator<=>(wide_duration a, wide_duration b) noexcept {
+    if ((a.num < 0) != (b.num < 0))
+      return a.num <=> b.num;
+    auto x = detail::multiply(detail::magnitude(a.num), static_cast<std::uint64_t>(b.den));
+    auto y = detail::multiply(detail::magnitude(b.num), static_cast<std::uint64_t>(a.den));
+    return a.num < 0 ? y <=> x : x <=> y;
+  }
+
+  [[nodiscard]] constexpr wide_duration reduced() const noexcept {
+    return {num, den};
+  }
+
+  // Whole multiples of d contained in this duration, rounded down.
+  [[nodiscard]] constexpr std::int64_t count_of(wide_duration d) const noexcept {
+    bool exact = true;
+    auto q = static_cast<std::int64_t>(detail::divide(
+        detail::multiply(detail::magnitude(num), static_cast<std::uint64_t>(d.den)),
+        detail::multiply(static_cast<std::uint64_t>(den), detail::magnitude(d.num)),
+        exact));
+    if ((num < 0) == (d.num < 0))
+      return q;
+    return exact ? -q : -q - 1;
+  }
+
+  [[nodiscard]] constexpr bool fits() const noexcept {
+    auto r = reduced();
+    return r.num >= INT16_MIN && r.num <= INT16_MAX && r.den <= INT16_MAX;
+  }
+
+  [[nodiscard]] constexpr duration narrow() const {
+    auto r = reduced();
+    if (!fits())
+      throw "duration does not fit the compact representation";
+    return {static_cast<int>(r.num), static_cast<int>(r.den)};
+  }
+
+  [[nodiscard]] constexpr double beats(int beat_den = 4) const noexcept {
+    return static_cast<double>(num) * beat_den / static_cast<double>(den);
+  }
+
+  static constexpr std::size_t max_chars = 41;
+
+  template <typename Out> constexpr Out write_to(Out out) const {
+    if (fits())
+      return narrow().write_to(out);
+    auto r = reduced();
+    out = detail::write_int(out, r.num);
+    *out++ = '/';
+    return detail::write_int(out, r.den);
+  }
+
+  [[nodiscard]] constexpr std::string str() const {
+    return detail::to_text<wide_duration, max_chars>(*this);
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const wide_duration &d) {
+    std::array<char, max_chars> buffer{};
+    return os << std::string_view(buffer.data(), d.write_to(buffer.data()));
   }
 };
 
+struct ticks {
+  std::int64_t count{0};
+
+  constexpr ticks() noexcept = default;
+  constexpr explicit ticks(std::int64_t c) noexcept : count(c) {}
+
+  [[nodiscard]] friend constexpr ticks operator+(ticks a, ticks b) noexcept {
+    return ticks{a.count + b.count};
+  }
+  [[nodiscard]] friend constexpr ticks operator-(ticks a, ticks b) noexcept {
+    return ticks{a.count - b.count};
+  }
+  [[nodiscard]] friend constexpr ticks operator*(ticks t, std::int64_t n) noexcept {
+    return ticks{t.count * n};
+  }
+  [[nodiscard]] friend constexpr ticks operator*(std::int64_t n, ticks t) noexcept {
+    return t * n;
+  }
+  constexpr ticks &operator+=(ticks other) noexcept {
+    count += other.count;
+    return *this;
+  }
+  constexpr ticks &operator-=(ticks other) noexcept {
+    count -= other.count;
+    return *this;
+  }
+
+  constexpr auto operator<=>(const ticks &) const noexcept = default;
+};
+
+struct timebase {
+  std::int32_t ppq{960};
+
+  constexpr timebase() noexcept = default;
+  constexpr explicit timebase(int pulses_per_quarter)
+      : ppq(pulses_per_quarter) {
+    if (pulses_per_quarter <= 0)
+      throw "PPQ must be positive";
+  }
+
+  [[nodiscard]] constexpr std::int64_t whole_ticks() const noexcept {
+    return std::int64_t{4} * ppq;
+  }
+
+  [[nodiscard]] constexpr bool is_exact(duration d) const noexcept {
+    return d.num * whole_ticks() % d.den == 0;
+  }
+
+  [[nodiscard]] constexpr ticks to_ticks(duration d) const {
+    auto scaled = d.num * whole_ticks();
+    if (scaled % d.den != 0)
+      throw "duration is not a whole number of ticks at this PPQ";
+    return ticks{scaled / d.den};
+  }
+
+  // Throws when the reduced value does not fit duration; use
+  // wide_duration{t.count, whole_ticks()} for arbitrary tick counts.
+  [[nodiscard]] constexpr duration to_duration(ticks t) const {
+    return wide_duration{t.count, whole_ticks()}.narrow();
+  }
+
+  constexpr auto operator<=>(const timebase &) const noexcept = default;
+};
+
 namespace durations {
 constexpr auto whole     = duration{1, 1};
 constexpr auto half      = duration{1, 2};
@@ -96,8 +338,11 @@ constexpr auto q = quarter;
 }
 
 template <>
-struct std::formatter<musicpp::duration> : std::formatter<std::string> {
-  auto format(const musicpp::duration &d, auto &ctx) const {
-    return std::formatter<std::string>::format(d.str(), ctx);
-  }
-};
+struct std::formatter<musicpp::duration>
+    : musicpp::detail::text_formatter<musicpp::duration,
+                                      musicpp::duration::max_chars> {};
+
+template <>
+struct std::formatter<musicpp::wide_duration>
+    : musicpp::detail::text_formatter<musicpp::wide_duration,
+                                      musicpp::wide_duration::max_chars> {};
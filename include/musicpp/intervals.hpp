@@ -1,10 +1,15 @@
 #pragma once
 
+#include "text.hpp"
 #include <array>
+#include <charconv>
+#include <cstddef>
 #include <cstdint>
 #include <format>
 #include <ostream>
 #include <string>
+#include <string_view>
+#include <system_error>
 
 namespace musicpp {
 
@@ -52,10 +57,13 @@ struct interval {
     return semitones() == other.semitones();
   }
 
-  [[nodiscard]] constexpr std::string str() const {
+  static constexpr std::size_t max_chars = 32;
+
+  template <typename Out> constexpr Out write_to(Out out) const {
     int raw_number = fifths * 4 + octaves * 7 + 1;
     if (raw_number < 1) {
-      return "-" + (-*this).str();
+      *out++ = '-';
+      return (-*this).write_to(out);
     }
 
     constexpr auto generic_map = std::to_array<int>({1, 5, 2, 6, 3, 7, 4});
@@ -64,31 +72,32 @@ struct interval {
     int f = ((fifths % 7) + 7) % 7;
     int quality_offset = (fifths - base_fifths_map[f]) / 7;
 
-    std::string result;
     bool is_perfect = (generic_map[f] == 1 || generic_map[f] == 4 || generic_map[f] == 5);
     if (is_perfect) {
-      if (quality_offset == 0)      result = "P";
-      else if (quality_offset == 1) result = "A";
-      else if (quality_offset == -1) result = "d";
-      else if (quality_offset > 1)  result = std::string(quality_offset, 'A');
-      else                          result = std::string(-quality_offset, 'd');
+      if (quality_offset == 0)      *out++ = 'P';
+      else if (quality_offset > 0)  out = detail::write_repeat(out, 'A', quality_offset);
+      else                          out = detail::write_repeat(out, 'd', -quality_offset);
     } else {
-      if (quality_offset == 0)      result = "M";
-      else if (quality_offset == -1) result = "m";
-      else if (quality_offset >= 1) result = std::string(quality_offset, 'A');
-      else                          result = std::string(-quality_offset - 1, 'd');
+      if (quality_offset == 0)      *out++ = 'M';
+      else if (quality_offset == -1) *out++ = 'm';
+      else if (quality_offset >= 1) out = detail::write_repeat(out, 'A', quality_offset);
+      else                          out = detail::write_repeat(out, 'd', -quality_offset - 1);
     }
-    result += std::to_string(raw_number);
-    return result;
+    return detail::write_int(out, raw_number);
+  }
+
+  [[nodiscard]] constexpr std::string str() const {
+    return detail::to_text<interval, max_chars>(*this);
   }
 
-  interval& operator+=(const interval& other) noexcept {
+  constexpr interval& operator+=(const interval& other) noexcept {
     *this = *this + other;
     return *this;
   }
 
   friend std::ostream &operator<<(std::ostream &os, const interval &iv) {
-    return os << iv.str();
+    std::array<char, max_chars> buffer{};
+    return os << std::string_view(buffer.data(), iv.write_to(buffer.data()));
   }
 };
 namespace intervals {
@@ -128,11 +137,74 @@ constexpr auto M13 = M6(1);
 constexpr auto m13 = m6(1);
 }
 
+constexpr std::from_chars_result from_chars(const char *first, const char *last,
+                                            interval &value) noexcept {
+  auto p = first;
+  bool descending = p != last && *p == '-';
+  if (descending)
+    ++p;
+  if (p == last)
+    return {first, std::errc::invalid_argument};
+
+  char quality = *p;
+  int count = 0;
+  while (p != last && *p == quality && (quality == 'A' || quality == 'd')) {
+    ++p;
+    ++count;
+  }
+  if (quality == 'P' || quality == 'M' || quality == 'm') {
+    ++p;
+    count = 1;
+  }
+  if (count == 0)
+    return {first, std::errc::invalid_argument};
+
+  int number = 0;
+  auto [end, ec] = detail::parse_int(p, last, number);
+  if (ec != std::errc{} || *p == '-' || number < 1)
+    return {first, ec == std::errc{} ? std::errc::invalid_argument : ec};
+
+  constexpr auto degree_fifths = std::to_array<int>({0, 2, 4, -1, 1, 3, 5});
+  int simple = (number - 1) % 7;
+  bool is_perfect = simple == 0 || simple == 3 || simple == 4;
+  int quality_offset = 0;
+  switch (quality) {
+  case 'P': if (!is_perfect) return {first, std::errc::invalid_argument}; break;
+  case 'M': if (is_perfect) return {first, std::errc::invalid_argument}; break;
+  case 'm':
+    if (is_perfect) return {first, std::errc::invalid_argument};
+    quality_offset = -1;
+    break;
+  case 'A': quality_offset = count; break;
+  default:  quality_offset = is_perfect ? -count : -count - 1; break;
+  }
+
+  int fifths = degree_fifths[static_cast<std::size_t>(simple)] + 7 * quality_offset;
+  int octaves = (number - 1 - fifths * 4) / 7;
+  if (descending) {
+    fifths = -fifths;
+    octaves = -octaves;
+  }
+  if (!detail::fits_int8(fifths) || !detail::fits_int8(octaves))
+    return {first, std::errc::result_out_of_range};
+  value = interval(static_cast<std::int8_t>(fifths),
+                   static_cast<std::int8_t>(octaves));
+  return {end, std::errc{}};
+}
+
+namespace literals {
+consteval interval operator""_iv(const char *text, std::size_t length) {
+  interval result;
+  auto [end, ec] = from_chars(text, text + length, result);
+  if (ec != std::errc{} || end != text + length)
+    throw "invalid interval literal";
+  return result;
+}
+}
+
 }
 
 template <>
-struct std::formatter<musicpp::interval> : std::formatter<std::string> {
-  auto format(const musicpp::interval &iv, auto &ctx) const {
-    return std::formatter<std::string>::format(iv.str(), ctx);
-  }
-};
\ No newline at end of file
+struct std::formatter<musicpp::interval>
+    : musicpp::detail::text_formatter<musicpp::interval,
+                                      musicpp::interval::max_chars> {};
\ No newline at end of file
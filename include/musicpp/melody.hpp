@@ -13,6 +13,8 @@ namespace musicpp {
 template <std::size_t S> struct scale_instance;
 struct time_signature;
 struct metric_position;
+class meter_map;
+class onset_index;
 
 
 struct melody_event {
@@ -25,11 +27,24 @@ struct melody_event {
     return {pitch, dur, is_rest, true};
   }
 
+  static constexpr std::size_t max_chars =
+      note::max_chars + duration::max_chars + 3;
+
+  template <typename Out> constexpr Out write_to(Out out) const {
+    if (is_rest)
+      *out++ = '-';
+    else
+      out = pitch.write_to(out);
+    *out++ = '(';
+    out = dur.write_to(out);
+    *out++ = ')';
+    if (is_tied && !is_rest)
+      *out++ = '~';
+    return out;
+  }
+
   [[nodiscard]] constexpr std::string str() const {
-    if (is_rest) return "-(" + dur.str() + ")";
-    auto s = pitch.str() + "(" + dur.str() + ")";
-    if (is_tied) s += "~";
-    return s;
+    return detail::to_text<melody_event, max_chars>(*this);
   }
 
   friend std::ostream &operator<<(std::ostream &os, const melody_event &ev) {
@@ -158,10 +173,17 @@ template <std::size_t N> struct melody {
     return highest() - lowest();
   }
 
-  [[nodiscard]] constexpr duration total_duration() const noexcept {
-    duration sum{0, 1};
+  [[nodiscard]] constexpr wide_duration total_duration() const {
+    wide_duration sum;
+    for (const auto &ev : events)
+      sum += ev.dur;
+    return sum.reduced();
+  }
+
+  [[nodiscard]] constexpr ticks total_ticks(timebase tb) const {
+    ticks sum{};
     for (const auto &ev : events)
-      sum = sum + ev.dur;
+      sum += tb.to_ticks(ev.dur);
     return sum;
   }
 
@@ -196,14 +218,21 @@ template <std::size_t N> struct melody {
   template <typename F>
   constexpr void walk(time_signature ts, F &&f) const;
 
+  template <typename F>
+  constexpr void walk(time_signature ts, timebase tb, F &&f) const;
+
+  template <typename F>
+  void walk(const meter_map &meters, F &&f) const;
+
+  [[nodiscard]] onset_index onsets() const;
+
+
+  template <typename Out> constexpr Out write_to(Out out) const {
+    return detail::write_joined(out, events, " ");
+  }
 
   [[nodiscard]] std::string str() const {
-    std::string result;
-    for (std::size_t i = 0; i < N; ++i) {
-      if (i > 0) result += ' ';
-      result += events[i].str();
-    }
-    return result;
+    return detail::to_text(*this);
   }
 
   friend std::ostream &operator<<(std::ostream &os, const melody &m) {
@@ -234,15 +263,10 @@ operator-(const melody<N> &m, const interval &iv) noexcept {
 
 
 template <>
-struct std::formatter<musicpp::melody_event> : std::formatter<std::string> {
-  auto format(const musicpp::melody_event &ev, auto &ctx) const {
-    return std::formatter<std::string>::format(ev.str(), ctx);
-  }
-};
+struct std::formatter<musicpp::melody_event>
+    : musicpp::detail::text_formatter<musicpp::melody_event,
+                                      musicpp::melody_event::max_chars> {};
 
 template <std::size_t N>
-struct std::formatter<musicpp::melody<N>> : std::formatter<std::string> {
-  auto format(const musicpp::melody<N> &m, auto &ctx) const {
-    return std::formatter<std::string>::format(m.str(), ctx);
-  }
-};
+struct std::formatter<musicpp::melody<N>>
+    : musicpp::detail::text_formatter<musicpp::melody<N>> {};
@@ -0,0 +1,134 @@
+#pragma once
+#include "chord_sequence.hpp"
+#include "duration.hpp"
+#include "melody.hpp"
+#include "timing.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace musicpp {
+
+// Time signature changes keyed by bar index. Every change records the score
+// position of its first bar, so both bar -> position and position -> bar
+// are a binary search over the changes plus one division.
+class meter_map {
+public:
+  explicit meter_map(time_signature initial = time_signatures::common) {
+    m_segments.push_back({0, initial, {}, bar_length(initial)});
+  }
+
+  // Switches to `ts` from bar `bar` (zero-based) onward.
+  meter_map &set_meter(int bar, time_signature ts) {
+    auto &last = m_segments.back();
+    if (bar < last.first_bar)
+      throw std::invalid_argument("meter changes must be added in order");
+    if (bar == last.first_bar) {
+      last.meter = ts;
+      last.bar_length = bar_length(ts);
+      return *this;
+    }
+    auto start = (last.start + last.bar_length * (bar - last.first_bar)).reduced();
+    m_segments.push_back({bar, ts, start, bar_length(ts)});
+    return *this;
+  }
+
+  [[nodiscard]] time_signature meter_at_bar(int bar) const noexcept {
+    return m_segments[find_bar(bar)].meter;
+  }
+
+  [[nodiscard]] time_signature meter_at(wide_duration at) const noexcept {
+    return m_segments[find_position(at)].meter;
+  }
+
+  [[nodiscard]] wide_duration bar_start(int bar) const {
+    const auto &seg = m_segments[find_bar(bar)];
+    return (seg.start + seg.bar_length * (bar - seg.first_bar)).reduced();
+  }
+
+  [[nodiscard]] metric_position position(wide_duration at) const {
+    return locate(at, m_segments[find_position(at)]);
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_segments.size(); }
+
+  template <std::size_t N, typename F>
+  void walk(const melody<N> &m, F &&f) const {
+    std::size_t seg = 0;
+    wide_duration at;
+    for (const auto &ev : m) {
+      f(ev, advance_to(at, seg));
+      at += ev.dur;
+    }
+  }
+
+  template <typename... Events, typename F>
+  void walk(const chord_sequence<Events...> &seq, F &&f) const {
+    std::size_t seg = 0;
+    wide_duration at;
+    seq.for_each([&](const auto &ev) {
+      f(ev, advance_to(at, seg));
+      at += ev.dur;
+    });
+  }
+
+private:
+  struct segment {
+    int first_bar;
+    time_signature meter;
+    wide_duration start;
+    wide_duration bar_length;
+  };
+
+  [[nodiscard]] static wide_duration bar_length(time_signature ts) {
+    if (ts.beats <= 0 || ts.beat_unit <= 0)
+      throw std::invalid_argument("time signature must be positive");
+    return ts.bar_duration();
+  }
+
+  [[nodiscard]] static metric_position locate(wide_duration at, const segment &seg) {
+    auto into = at - seg.start;
+    auto bars = into.count_of(seg.bar_length);
+    return {seg.first_bar + static_cast<int>(bars),
+            (into - seg.bar_length * bars).narrow()};
+  }
+
+  [[nodiscard]] std::size_t find_bar(int bar) const noexcept {
+    auto it = std::upper_bound(
+        m_segments.begin() + 1, m_segments.end(), bar,
+        [](int b, const segment &seg) { return b < seg.first_bar; });
+    return static_cast<std::size_t>(it - m_segments.begin()) - 1;
+  }
+
+  [[nodiscard]] std::size_t find_position(wide_duration at) const noexcept {
+    auto it = std::upper_bound(
+        m_segments.begin() + 1, m_segments.end(), at,
+        [](wide_duration x, const segment &seg) { return x < seg.start; });
+    return static_cast<std::size_t>(it - m_segments.begin()) - 1;
+  }
+
+  [[nodiscard]] metric_position advance_to(wide_duration at,
+                                           std::size_t &seg) const {
+    while (seg + 1 < m_segments.size() && m_segments[seg + 1].start <= at)
+      ++seg;
+    return locate(at, m_segments[seg]);
+  }
+
+  std::vector<segment> m_segments;
+};
+
+template <std::size_t N>
+template <typename F>
+void melody<N>::walk(const meter_map &meters, F &&f) const {
+  meters.walk(*this, std::forward<F>(f));
+}
+
+template <typename... Events>
+template <typename F>
+void chord_sequence<Events...>::walk(const meter_map &meters, F &&f) const {
+  meters.walk(*this, std::forward<F>(f));
+}
+
+}
@@ -1,12 +1,28 @@
 #pragma once
 
+#include "analysis_cache.hpp"
+#include "batch.hpp"
+#include "chord_dictionary.hpp"
+#include "chord_scoring.hpp"
 #include "chord_sequence.hpp"
+#include "chord_symbols.hpp"
 #include "chords.hpp"
 #include "degree.hpp"
 #include "duration.hpp"
 #include "intervals.hpp"
 #include "notes.hpp"
+#include "onset_index.hpp"
+#include "packed_events.hpp"
+#include "parallel.hpp"
+#include "pitch_class_set.hpp"
+#include "playback.hpp"
 #include "progressions.hpp"
+#include "quantizer.hpp"
+#include "recognizer.hpp"
 #include "scales.hpp"
+#include "spelling.hpp"
+#include "tempo_map.hpp"
 #include "timing.hpp"
+#include "tuning.hpp"
 #include "melody.hpp"
+#include "meter_map.hpp"
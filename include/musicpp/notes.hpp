@@ -1,15 +1,47 @@
 #pragma once
 #include "intervals.hpp"
+#include "text.hpp"
+#include <algorithm>
 #include <array>
+#include <charconv>
+#include <cstddef>
 #include <cstdint>
 #include <format>
 #include <ostream>
+#include <span>
 #include <string>
+#include <string_view>
+#include <system_error>
 
 namespace musicpp {
 
 enum class accidental_preference { natural, sharp, flat };
 
+namespace detail {
+inline constexpr auto fifth_pitch_classes = [] {
+  std::array<std::int8_t, 256> table{};
+  for (int i = 0; i < 256; ++i) {
+    int fifth = static_cast<std::int8_t>(i);
+    table[static_cast<std::size_t>(i)] =
+        static_cast<std::int8_t>(((fifth * 7) % 12 + 12) % 12);
+  }
+  return table;
+}();
+
+inline constexpr auto fifth_simplify_steps = [] {
+  constexpr auto offsets = std::to_array<int>({5, 1, 6});
+  std::array<std::array<std::int8_t, 256>, 3> table{};
+  for (std::size_t pref = 0; pref < table.size(); ++pref) {
+    for (int i = 0; i < 256; ++i) {
+      int shifted = static_cast<std::int8_t>(i) + offsets[pref];
+      table[pref][static_cast<std::size_t>(i)] = static_cast<std::int8_t>(
+          (shifted >= 0) ? shifted / 12 : (shifted - 11) / 12);
+    }
+  }
+  return table;
+}();
+}
+
 struct note {
   std::int8_t m_fifth{0};
   std::int8_t m_octave{0};
@@ -54,8 +86,7 @@ struct note {
   }
 
   [[nodiscard]] constexpr std::int8_t get_pitch() const noexcept {
-    auto pitch = static_cast<std::int8_t>((m_fifth * 7) % 12);
-    return static_cast<std::int8_t>((pitch + 12) % 12);
+    return detail::fifth_pitch_classes[static_cast<std::uint8_t>(m_fifth)];
   }
 
   [[nodiscard]] constexpr bool
@@ -65,11 +96,8 @@ struct note {
 
   [[nodiscard]] constexpr note
   simplify(accidental_preference pref = accidental_preference::natural) const noexcept {
-    int offset = (pref == accidental_preference::sharp)  ? 1
-               : (pref == accidental_preference::flat)   ? 6
-               :                                          5;
-    int shifted = m_fifth + offset;
-    int adjust = (shifted >= 0) ? shifted / 12 : (shifted - 11) / 12;
+    int adjust = detail::fifth_simplify_steps[static_cast<std::size_t>(pref)]
+                                             [static_cast<std::uint8_t>(m_fifth)];
     return note(
         static_cast<std::int8_t>(m_fifth - adjust * 12),
         static_cast<std::int8_t>(m_octave + adjust * 7)
@@ -78,46 +106,38 @@ struct note {
 
   constexpr auto operator<=>(const note &) const noexcept = default;
 
-  [[nodiscard]] constexpr std::string str() const {
-    constexpr std::array<const char *, 7> names = {"F", "C", "G", "D",
-                                                    "A", "E", "B"};
-    std::int64_t shifted_fifth = m_fifth + 1;
-    std::int64_t base_index = ((shifted_fifth % 7) + 7) % 7;
-    std::int64_t accidentals =
+  static constexpr std::size_t max_chars = 24;
+
+  template <typename Out> constexpr Out write_pitch_name(Out out) const {
+    constexpr std::string_view names = "FCGDAEB";
+    int shifted_fifth = m_fifth + 1;
+    int base_index = ((shifted_fifth % 7) + 7) % 7;
+    int accidentals =
         (shifted_fifth >= 0) ? shifted_fifth / 7 : (shifted_fifth - 6) / 7;
-    std::string result = names[base_index];
-    if (accidentals > 0) {
-      for (std::int64_t i = 0; i < accidentals; ++i)
-        result += "#";
-    } else if (accidentals < 0) {
-      for (std::int64_t i = 0; i < -accidentals; ++i)
-        result += "b";
-    }
-    int display_octave = (get_midi_pitch() - get_pitch()) / 12 - 1;
-    result += std::to_string(display_octave);
-    return result;
+    *out++ = names[static_cast<std::size_t>(base_index)];
+    if (accidentals > 0)
+      return detail::write_repeat(out, '#', accidentals);
+    return detail::write_repeat(out, 'b', -accidentals);
+  }
+
+  template <typename Out> constexpr Out write_to(Out out) const {
+    out = write_pitch_name(out);
+    return detail::write_int(out, (get_midi_pitch() - get_pitch()) / 12 - 1);
+  }
+
+  [[nodiscard]] constexpr std::string str() const {
+    return detail::to_text<note, max_chars>(*this);
   }
 
   [[nodiscard]] constexpr std::string pitch_name() const {
-    constexpr std::array<const char *, 7> names = {"F", "C", "G", "D",
-                                                    "A", "E", "B"};
-    std::int64_t shifted_fifth = m_fifth + 1;
-    std::int64_t base_index = ((shifted_fifth % 7) + 7) % 7;
-    std::int64_t accidentals =
-        (shifted_fifth >= 0) ? shifted_fifth / 7 : (shifted_fifth - 6) / 7;
-    std::string result = names[base_index];
-    if (accidentals > 0) {
-      for (std::int64_t i = 0; i < accidentals; ++i)
-        result += "#";
-    } else if (accidentals < 0) {
-      for (std::int64_t i = 0; i < -accidentals; ++i)
-        result += "b";
-    }
-    return result;
+    std::array<char, max_chars> buffer{};
+    auto end = write_pitch_name(buffer.data());
+    return std::string(buffer.data(), end);
   }
 
   friend std::ostream &operator<<(std::ostream &os, const note &n) {
-    return os << n.str();
+    std::array<char, max_chars> buffer{};
+    return os << std::string_view(buffer.data(), n.write_to(buffer.data()));
   }
 };
 namespace notes {
@@ -141,11 +161,94 @@ constexpr auto Db = note(-5, 3);
 constexpr auto Gb = note(-6, 4);
 }
 
+constexpr std::span<note> transpose_notes(std::span<const note> in,
+                                          const interval &iv,
+                                          std::span<note> out) noexcept {
+  const auto count = std::min(in.size(), out.size());
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = in[i] + iv;
+  return out.first(count);
+}
+
+constexpr void transpose_notes(std::span<note> notes, const interval &iv) noexcept {
+  for (auto &n : notes)
+    n = n + iv;
+}
+
+constexpr std::span<std::int8_t> midi_pitches(std::span<const note> in,
+                                              std::span<std::int8_t> out) noexcept {
+  const auto count = std::min(in.size(), out.size());
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = in[i].get_midi_pitch();
+  return out.first(count);
+}
+
+constexpr std::span<std::int8_t> pitch_classes(std::span<const note> in,
+                                               std::span<std::int8_t> out) noexcept {
+  const auto count = std::min(in.size(), out.size());
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = in[i].get_pitch();
+  return out.first(count);
+}
+
+constexpr void simplify_notes(std::span<note> notes,
+                              accidental_preference pref =
+                                  accidental_preference::natural) noexcept {
+  for (auto &n : notes)
+    n = n.simplify(pref);
+}
+
+namespace detail {
+constexpr const char *parse_pitch_name(const char *first, const char *last,
+                                       int &fifth) noexcept {
+  constexpr auto letter_fifths = std::to_array<std::int8_t>({3, 5, 0, 2, 4, -1, 1});
+  if (first == last || *first < 'A' || *first > 'G')
+    return first;
+  auto p = first;
+  fifth = letter_fifths[static_cast<std::size_t>(*p++ - 'A')];
+  for (; p != last && (*p == '#' || *p == 'b'); ++p)
+    fifth += *p == '#' ? 7 : -7;
+  return p;
+}
+
+constexpr std::errc make_note(int fifth, int display_octave, note &value) noexcept {
+  int fifth_octaves = fifth * 7 >= 0 ? fifth * 7 / 12 : (fifth * 7 - 11) / 12;
+  int octave = display_octave - fifth_octaves;
+  if (!fits_int8(fifth) || !fits_int8(octave))
+    return std::errc::result_out_of_range;
+  value = note(static_cast<std::int8_t>(fifth), static_cast<std::int8_t>(octave));
+  return std::errc{};
+}
+}
+
+constexpr std::from_chars_result from_chars(const char *first, const char *last,
+                                            note &value) noexcept {
+  int fifth = 0;
+  auto p = detail::parse_pitch_name(first, last, fifth);
+  if (p == first)
+    return {first, std::errc::invalid_argument};
+
+  int display_octave = 0;
+  auto [end, ec] = detail::parse_int(p, last, display_octave);
+  if (ec == std::errc{})
+    ec = detail::make_note(fifth, display_octave, value);
+  if (ec != std::errc{})
+    return {first, ec};
+  return {end, std::errc{}};
+}
+
+namespace literals {
+consteval note operator""_n(const char *text, std::size_t length) {
+  note result;
+  auto [end, ec] = from_chars(text, text + length, result);
+  if (ec != std::errc{} || end != text + length)
+    throw "invalid note literal";
+  return result;
+}
+}
+
 }
 
 template <>
-struct std::formatter<musicpp::note> : std::formatter<std::string> {
-  auto format(const musicpp::note &n, auto &ctx) const {
-    return std::formatter<std::string>::format(n.str(), ctx);
-  }
-};
\ No newline at end of file
+struct std::formatter<musicpp::note>
+    : musicpp::detail::text_formatter<musicpp::note, musicpp::note::max_chars> {};
\ No newline at end of file
@@ -0,0 +1,204 @@
+#pragma once
+#include "chord_sequence.hpp"
+#include "duration.hpp"
+#include "melody.hpp"
+#include "timing.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace musicpp {
+
+struct event_range {
+  std::size_t first{0};
+  std::size_t last{0};
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept { return last - first; }
+  [[nodiscard]] constexpr bool empty() const noexcept { return first == last; }
+  constexpr bool operator==(const event_range &) const noexcept = default;
+};
+
+// Event onsets of a melody or chord sequence, built once. Onsets are stored
+// as integers over the least common denominator of every duration in the
+// stream, so lookups compare plain int64 values.
+class onset_index {
+public:
+  onset_index() = default;
+
+  template <std::size_t N> explicit onset_index(const melody<N> &m) {
+    build(N, [&](auto &&push) {
+      for (const auto &ev : m)
+        push(ev.dur);
+    });
+  }
+
+  template <typename... Events>
+  explicit onset_index(const chord_sequence<Events...> &seq) {
+    build(sizeof...(Events), [&](auto &&push) {
+      seq.for_each([&](const auto &ev) { push(ev.dur); });
+    });
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return m_onsets.empty() ? 0 : m_onsets.size() - 1;
+  }
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+  [[nodiscard]] wide_duration onset(std::size_t i) const noexcept {
+    return wide_duration{m_onsets[i], m_unit}.reduced();
+  }
+
+  [[nodiscard]] wide_duration total_duration() const noexcept {
+    return m_onsets.empty() ? wide_duration{} : onset(size());
+  }
+
+  [[nodiscard]] metric_position position(std::size_t i, time_signature ts) const {
+    return position_at(onset(i), ts);
+  }
+
+  // Index of the event sounding at `at`, or size() when `at` lies before
+  // the first onset or at or after the end.
+  [[nodiscard]] std::size_t seek(wide_duration at) const noexcept {
+    const auto units = to_units(at);
+    auto it = std::upper_bound(m_onsets.begin(), m_onsets.end(), units);
+    if (it == m_onsets.begin() || it == m_onsets.end())
+      return size();
+    return static_cast<std::size_t>(it - m_onsets.begin()) - 1;
+  }
+
+  [[nodiscard]] std::size_t seek(const metric_position &pos,
+                                 time_signature ts) const {
+    return seek(pos.elapsed(ts));
+  }
+
+  [[nodiscard]] std::size_t seek(ticks at, timebase tb) const noexcept {
+    return seek(wide_duration{at.count, tb.whole_ticks()});
+  }
+
+  // Events sounding at any point of [from, to).
+  [[nodiscard]] event_range overlapping(wide_duration from,
+                                        wide_duration to) const noexcept {
+    if (empty() || !(from < to))
+      return {};
+    auto first = std::upper_bound(m_onsets.begin() + 1, m_onsets.end(),
+                                  to_units(from)) - (m_onsets.begin() + 1);
+    auto last = std::lower_bound(m_onsets.begin(), m_onsets.end() - 1,
+                                 to_units_ceil(to)) - m_onsets.begin();
+    return clamp(first, last);
+  }
+
+  // Events whose onset lies in [from, to).
+  [[nodiscard]] event_range starting_in(wide_duration from,
+                                        wide_duration to) const noexcept {
+    if (empty() || !(from < to))
+      return {};
+    auto first = std::lower_bound(m_onsets.begin(), m_onsets.end() - 1,
+                                  to_units_ceil(from)) - m_onsets.begin();
+    auto last = std::lower_bound(m_onsets.begin(), m_onsets.end() - 1,
+                                 to_units_ceil(to)) - m_onsets.begin();
+    return clamp(first, last);
+  }
+
+  // Sorted input is answered in one merge over the onsets; an element that
+  // goes backwards restarts with a binary search.
+  std::span<std::size_t> seek(std::span<const wide_duration> times,
+                              std::span<std::size_t> out) const noexcept {
+    return seek_sorted(times, out, [](wide_duration at) { return at; });
+  }
+
+  std::span<std::size_t> seek(std::span<const ticks> times, timebase tb,
+                              std::span<std::size_t> out) const noexcept {
+    return seek_sorted(times, out, [tb](ticks at) {
+      return wide_duration{at.count, tb.whole_ticks()};
+    });
+  }
+
+private:
+  // A running wide_duration sum only ever grows its denominator to the lcm
+  // of what it has seen, so every prefix divides evenly into the final one.
+  template <typename Visit> void build(std::size_t count, Visit visit) {
+    std::vector<wide_duration> sums;
+    sums.reserve(count + 1);
+    wide_duration total;
+    visit([&](duration d) {
+      sums.push_back(total);
+      total += d;
+    });
+    sums.push_back(total);
+    m_unit = total.den;
+    m_onsets.resize(sums.size());
+    for (std::size_t i = 0; i < sums.size(); ++i)
+      m_onsets[i] = sums[i].num * (m_unit / sums[i].den);
+  }
+
+  // Rounds down, so an onset o satisfies o <= at exactly when
+  // o <= to_units(at).
+  [[nodiscard]] std::int64_t to_units(wide_duration at) const noexcept {
+    return scale(at, false);
+  }
+
+  // Rounds up, so o < at exactly when o < to_units_ceil(at).
+  [[nodiscard]] std::int64_t to_units_ceil(wide_duration at) const noexcept {
+    return scale(at, true);
+  }
+
+  // at * m_unit, formed in 128 bits. Times outside the stream clamp to one
+  // unit beyond either end, which keeps both roundings above true.
+  [[nodiscard]] std::int64_t scale(wide_duration at, bool up) const noexcept {
+    if (m_onsets.empty())
+      return 0;
+    if (at < wide_duration{})
+      return -1;
+    if (at > wide_duration{m_onsets.back(), m_unit})
+      return m_onsets.back() + 1;
+    bool exact = true;
+    auto q = static_cast<std::int64_t>(detail::divide(
+        detail::multiply(static_cast<std::uint64_t>(at.num),
+                         static_cast<std::uint64_t>(m_unit)),
+        {0, static_cast<std::uint64_t>(at.den)}, exact));
+    return up && !exact ? q + 1 : q;
+  }
+
+  [[nodiscard]] static event_range clamp(std::ptrdiff_t first,
+                                         std::ptrdiff_t last) noexcept {
+    if (last <= first)
+      return {};
+    return {static_cast<std::size_t>(first), static_cast<std::size_t>(last)};
+  }
+
+  template <typename In, typename Key>
+  std::span<std::size_t> seek_sorted(std::span<const In> in,
+                                     std::span<std::size_t> out,
+                                     Key key) const noexcept {
+    const auto count = std::min(in.size(), out.size());
+    std::size_t i = 0;
+    for (std::size_t k = 0; k < count; ++k) {
+      const auto units = to_units(key(in[k]));
+      if (i > 0 && units < m_onsets[i - 1])
+        i = static_cast<std::size_t>(
+            std::upper_bound(m_onsets.begin(), m_onsets.end(), units) -
+            m_onsets.begin());
+      while (i < m_onsets.size() && m_onsets[i] <= units)
+        ++i;
+      out[k] = (i == 0 || i == m_onsets.size()) ? size() : i - 1;
+    }
+    return out.first(count);
+  }
+
+  std::vector<std::int64_t> m_onsets;
+  std::int64_t m_unit{1};
+};
+
+template <std::size_t N>
+onset_index melody<N>::onsets() const {
+  return onset_index(*this);
+}
+
+template <typename... Events>
+onset_index chord_sequence<Events...>::onsets() const {
+  return onset_index(*this);
+}
+
+}
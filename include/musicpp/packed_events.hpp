@@ -0,0 +1,319 @@
+#pragma once
+#include "chord_sequence.hpp"
+#include "duration.hpp"
+#include "melody.hpp"
+#include "notes.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace musicpp {
+
+namespace detail {
+[[nodiscard]] constexpr std::uint16_t pack_note(const note &n) noexcept {
+  return static_cast<std::uint16_t>(static_cast<std::uint8_t>(n.get_fifth()) |
+                                    static_cast<std::uint8_t>(n.get_octave()) << 8);
+}
+
+[[nodiscard]] constexpr note unpack_note(std::uint16_t bits) noexcept {
+  return note(static_cast<std::int8_t>(bits & 0xffu),
+              static_cast<std::int8_t>(bits >> 8));
+}
+
+[[nodiscard]] constexpr std::uint32_t duration_key(const duration &d) noexcept {
+  return static_cast<std::uint16_t>(d.num) |
+         static_cast<std::uint32_t>(static_cast<std::uint16_t>(d.den)) << 16;
+}
+}
+
+class duration_table {
+public:
+  static constexpr std::size_t max_size = 1u << 14;
+
+  duration_table() {
+    using namespace durations;
+    for (auto d : {quarter, eighth, half, sixteenth, whole, duration{1, 32},
+                   quarter.dotted(), eighth.dotted(), half.dotted(),
+                   quarter.triplet(), eighth.triplet(), sixteenth.triplet()})
+      (void)intern(d);
+  }
+
+  [[nodiscard]] std::uint16_t intern(const duration &d) {
+    auto [it, inserted] = m_index.try_emplace(
+        detail::duration_key(d), static_cast<std::uint16_t>(m_values.size()));
+    if (inserted) {
+      if (m_values.size() == max_size) {
+        m_index.erase(it);
+        throw std::length_error("duration table holds at most 16384 entries");
+      }
+      m_values.push_back(d);
+    }
+    return it->second;
+  }
+
+  [[nodiscard]] std::optional<std::uint16_t> find(const duration &d) const {
+    auto it = m_index.find(detail::duration_key(d));
+    if (it == m_index.end())
+      return std::nullopt;
+    return it->second;
+  }
+
+  [[nodiscard]] duration operator[](std::uint16_t index) const noexcept {
+    return m_values[index];
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_values.size(); }
+
+private:
+  std::vector<duration> m_values;
+  std::unordered_map<std::uint32_t, std::uint16_t> m_index;
+};
+
+// Bits 0-15: packed note (fifth, octave); 16-29: duration index;
+// 30: rest; 31: tie.
+struct packed_event {
+  std::uint32_t bits{0};
+
+  constexpr packed_event() noexcept = default;
+  constexpr packed_event(const note &pitch, std::uint16_t duration_index,
+                         bool is_rest, bool is_tied) noexcept
+      : bits(detail::pack_note(pitch) |
+             static_cast<std::uint32_t>(duration_index & 0x3fffu) << 16 |
+             static_cast<std::uint32_t>(is_rest) << 30 |
+             static_cast<std::uint32_t>(is_tied) << 31) {}
+
+  [[nodiscard]] constexpr note pitch() const noexcept {
+    return detail::unpack_note(static_cast<std::uint16_t>(bits));
+  }
+  [[nodiscard]] constexpr std::uint16_t duration_index() const noexcept {
+    return static_cast<std::uint16_t>(bits >> 16 & 0x3fffu);
+  }
+  [[nodiscard]] constexpr bool is_rest() const noexcept { return bits >> 30 & 1u; }
+  [[nodiscard]] constexpr bool is_tied() const noexcept { return bits >> 31; }
+
+  [[nodiscard]] melody_event unpack(const duration_table &table) const noexcept {
+    return {pitch(), table[duration_index()], is_rest(), is_tied()};
+  }
+
+  constexpr bool operator==(const packed_event &) const noexcept = default;
+};
+
+static_assert(sizeof(packed_event) == 4);
+
+class packed_melody {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = melody_event;
+    using difference_type = std::ptrdiff_t;
+    using reference = melody_event;
+    using pointer = void;
+
+    iterator() noexcept = default;
+    iterator(const packed_event *pos, const duration_table *table) noexcept
+        : m_pos(pos), m_table(table) {}
+
+    [[nodiscard]] melody_event operator*() const noexcept {
+      return m_pos->unpack(*m_table);
+    }
+    [[nodiscard]] melody_event operator[](difference_type n) const noexcept {
+      return m_pos[n].unpack(*m_table);
+    }
+    iterator &operator++() noexcept { ++m_pos; return *this; }
+    iterator operator++(int) noexcept { auto old = *this; ++m_pos; return old; }
+    iterator &operator--() noexcept { --m_pos; return *this; }
+    iterator operator--(int) noexcept { auto old = *this; --m_pos; return old; }
+    iterator &operator+=(difference_type n) noexcept { m_pos += n; return *this; }
+    iterator &operator-=(difference_type n) noexcept { m_pos -= n; return *this; }
+    [[nodiscard]] friend iterator operator+(iterator it, difference_type n) noexcept {
+      return it += n;
+    }
+    [[nodiscard]] friend iterator operator+(difference_type n, iterator it) noexcept {
+      return it += n;
+    }
+    [[nodiscard]] friend iterator operator-(iterator it, difference_type n) noexcept {
+      return it -= n;
+    }
+    [[nodiscard]] friend difference_type operator-(const iterator &a,
+                                                   const iterator &b) noexcept {
+      return a.m_pos - b.m_pos;
+    }
+    [[nodiscard]] friend bool operator==(const iterator &a, const iterator &b) noexcept {
+      return a.m_pos == b.m_pos;
+    }
+    [[nodiscard]] friend auto operator<=>(const iterator &a, const iterator &b) noexcept {
+      return a.m_pos <=> b.m_pos;
+    }
+
+  private:
+    const packed_event *m_pos{nullptr};
+    const duration_table *m_table{nullptr};
+  };
+
+  packed_melody() = default;
+
+  void push_back(const melody_event &ev) {
+    m_events.emplace_back(ev.pitch, m_durations.intern(ev.dur), ev.is_rest,
+                          ev.is_tied);
+  }
+
+  template <std::size_t N> void append(const melody<N> &m) {
+    m_events.reserve(m_events.size() + N);
+    for (const auto &ev : m.events)
+      push_back(ev);
+  }
+
+  void reserve(std::size_t n) { m_events.reserve(n); }
+  void clear() noexcept { m_events.clear(); }
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_events.size(); }
+  [[nodiscard]] bool empty() const noexcept { return m_events.empty(); }
+
+  [[nodiscard]] melody_event operator[](std::size_t i) const noexcept {
+    return m_events[i].unpack(m_durations);
+  }
+
+  template <std::size_t N>
+  [[nodiscard]] melody<N> to_melody(std::size_t first = 0) const {
+    if (first + N > m_events.size())
+      throw std::out_of_range("packed melody is shorter than requested");
+    melody<N> result{};
+    for (std::size_t i = 0; i < N; ++i)
+      result.events[i] = (*this)[first + i];
+    return result;
+  }
+
+  [[nodiscard]] iterator begin() const noexcept {
+    return {m_events.data(), &m_durations};
+  }
+  [[nodiscard]] iterator end() const noexcept {
+    return {m_events.data() + m_events.size(), &m_durations};
+  }
+
+  [[nodiscard]] std::span<const packed_event> packed() const noexcept {
+    return m_events;
+  }
+  [[nodiscard]] const duration_table &durations() const noexcept {
+    return m_durations;
+  }
+
+private:
+  std::vector<packed_event> m_events;
+  duration_table m_durations;
+};
+
+// A chord is stored as a 16-bit header (duration index and flags laid out
+// like the upper half of packed_event), a 16-bit note count, and one
+// 16-bit word per note.
+class packed_chord_view {
+public:
+  packed_chord_view(const std::uint16_t *words, const duration_table *table) noexcept
+      : m_words(words), m_table(table) {}
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_words[1]; }
+  [[nodiscard]] note operator[](std::size_t i) const noexcept {
+    return detail::unpack_note(m_words[2 + i]);
+  }
+  [[nodiscard]] duration dur() const noexcept {
+    return (*m_table)[static_cast<std::uint16_t>(m_words[0] & 0x3fffu)];
+  }
+  [[nodiscard]] bool is_rest() const noexcept { return m_words[0] >> 14 & 1u; }
+  [[nodiscard]] bool is_tied() const noexcept { return m_words[0] >> 15; }
+
+  template <std::size_t N> [[nodiscard]] chord_event<N> unpack() const {
+    if (size() != N)
+      throw std::invalid_argument("packed chord has a different number of notes");
+    chord_event<N> result{{}, dur(), is_rest(), is_tied()};
+    for (std::size_t i = 0; i < N; ++i)
+      result.chord.notes[i] = (*this)[i];
+    return result;
+  }
+
+private:
+  const std::uint16_t *m_words;
+  const duration_table *m_table;
+};
+
+class packed_chords {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = packed_chord_view;
+    using difference_type = std::ptrdiff_t;
+    using reference = packed_chord_view;
+    using pointer = void;
+
+    iterator() noexcept = default;
+    iterator(const std::uint16_t *pos, const duration_table *table) noexcept
+        : m_pos(pos), m_table(table) {}
+
+    [[nodiscard]] packed_chord_view operator*() const noexcept {
+      return {m_pos, m_table};
+    }
+    iterator &operator++() noexcept {
+      m_pos += 2 + m_pos[1];
+      return *this;
+    }
+    iterator operator++(int) noexcept { auto old = *this; ++*this; return old; }
+    [[nodiscard]] friend bool operator==(const iterator &a, const iterator &b) noexcept {
+      return a.m_pos == b.m_pos;
+    }
+
+  private:
+    const std::uint16_t *m_pos{nullptr};
+    const duration_table *m_table{nullptr};
+  };
+
+  packed_chords() = default;
+
+  template <std::size_t N> void push_back(const chord_event<N> &ev) {
+    static_assert(N <= UINT16_MAX, "chord is too large to pack");
+    auto index = m_durations.intern(ev.dur);
+    m_words.push_back(static_cast<std::uint16_t>(index | ev.is_rest << 14 |
+                                                 ev.is_tied << 15));
+    m_words.push_back(static_cast<std::uint16_t>(N));
+    for (const auto &n : ev.chord.notes)
+      m_words.push_back(detail::pack_note(n));
+    ++m_count;
+  }
+
+  template <typename... Events> void append(const chord_sequence<Events...> &seq) {
+    seq.for_each([&](const auto &ev) { push_back(ev); });
+  }
+
+  void clear() noexcept {
+    m_words.clear();
+    m_count = 0;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_count; }
+  [[nodiscard]] bool empty() const noexcept { return m_count == 0; }
+
+  [[nodiscard]] iterator begin() const noexcept {
+    return {m_words.data(), &m_durations};
+  }
+  [[nodiscard]] iterator end() const noexcept {
+    return {m_words.data() + m_words.size(), &m_durations};
+  }
+
+  [[nodiscard]] std::span<const std::uint16_t> packed() const noexcept {
+    return m_words;
+  }
+  [[nodiscard]] const duration_table &durations() const noexcept {
+    return m_durations;
+  }
+
+private:
+  std::vector<std::uint16_t> m_words;
+  std::size_t m_count{0};
+  duration_table m_durations;
+};
+
+}
@@ -0,0 +1,220 @@
+#pragma once
+#include "batch.hpp"
+#include "chords.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace musicpp {
+
+struct parallel_options {
+  std::size_t threads{0};
+  std::size_t grain{0};
+
+  [[nodiscard]] std::size_t thread_count() const noexcept {
+    if (threads)
+      return threads;
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  }
+};
+
+namespace detail {
+class work_range {
+public:
+  void assign(std::uint32_t begin, std::uint32_t end) noexcept {
+    m_range.store(pack(begin, end), std::memory_order_relaxed);
+  }
+
+  bool pop(std::uint32_t grain, std::uint32_t &begin,
+           std::uint32_t &end) noexcept {
+    auto r = m_range.load(std::memory_order_acquire);
+    while (first(r) < last(r)) {
+      auto stop = first(r) + std::min(grain, last(r) - first(r));
+      if (m_range.compare_exchange_weak(r, pack(stop, last(r)),
+                                        std::memory_order_acq_rel)) {
+        begin = first(r);
+        end = stop;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool steal(std::uint32_t grain, std::uint32_t &begin,
+             std::uint32_t &end) noexcept {
+    auto r = m_range.load(std::memory_order_acquire);
+    while (last(r) - first(r) > grain) {
+      auto mid = first(r) + (last(r) - first(r) + 1) / 2;
+      if (m_range.compare_exchange_weak(r, pack(first(r), mid),
+                                        std::memory_order_acq_rel)) {
+        begin = mid;
+        end = last(r);
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  static constexpr std::uint64_t pack(std::uint32_t begin,
+                                      std::uint32_t end) noexcept {
+    return (std::uint64_t{begin} << 32) | end;
+  }
+  static constexpr std::uint32_t first(std::uint64_t r) noexcept {
+    return static_cast<std::uint32_t>(r >> 32);
+  }
+  static constexpr std::uint32_t last(std::uint64_t r) noexcept {
+    return static_cast<std::uint32_t>(r);
+  }
+
+  alignas(64) std::atomic<std::uint64_t> m_range{0};
+};
+
+template <typename Scratch, typename F>
+void parallel_for(std::size_t count, const parallel_options &opts, F &&f) {
+  if (count == 0)
+    return;
+  auto workers = std::min(opts.thread_count(), count);
+  auto grain = opts.grain ? opts.grain
+                          : std::clamp<std::size_t>(count / (workers * 16), 1, 1024);
+
+  if (workers == 1) {
+    Scratch scratch{};
+    for (std::size_t first = 0; first < count; first += grain)
+      f(scratch, first, std::min(first + grain, count));
+    return;
+  }
+
+  constexpr std::size_t max_range = UINT32_MAX;
+  for (std::size_t base = 0; base < count; base += max_range) {
+    auto n = std::min(count - base, max_range);
+    auto step = static_cast<std::uint32_t>(std::min(grain, n));
+    std::vector<work_range> ranges(workers);
+    for (std::size_t w = 0; w < workers; ++w)
+      ranges[w].assign(static_cast<std::uint32_t>(n * w / workers),
+                       static_cast<std::uint32_t>(n * (w + 1) / workers));
+
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto run = [&](std::size_t self) {
+      Scratch scratch{};
+      std::uint32_t begin = 0, end = 0;
+      try {
+        while (!failed.load(std::memory_order_relaxed)) {
+          if (ranges[self].pop(step, begin, end)) {
+            f(scratch, base + begin, base + end);
+            continue;
+          }
+          bool stolen = false;
+          for (std::size_t k = 1; k < workers && !stolen; ++k) {
+            auto victim = (self + k) % workers;
+            if (ranges[victim].steal(step, begin, end)) {
+              ranges[self].assign(begin, end);
+              stolen = true;
+            }
+          }
+          if (!stolen)
+            break;
+        }
+      } catch (...) {
+        std::lock_guard lock(error_mutex);
+        if (!error)
+          error = std::current_exception();
+        failed.store(true, std::memory_order_relaxed);
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t w = 1; w < workers; ++w)
+      threads.emplace_back(run, w);
+    run(0);
+    for (auto &t : threads)
+      t.join();
+    if (error)
+      std::rethrow_exception(error);
+  }
+}
+
+struct no_scratch {};
+}
+
+template <typename Scratch, typename T, typename F>
+[[nodiscard]] auto parallel_map(std::span<const T> items, F &&f,
+                                const parallel_options &opts = {}) {
+  using result_type =
+      std::decay_t<std::invoke_result_t<F &, Scratch &, const T &>>;
+  std::vector<result_type> results(items.size());
+  detail::parallel_for<Scratch>(
+      items.size(), opts,
+      [&](Scratch &scratch, std::size_t first, std::size_t last) {
+        for (auto i = first; i < last; ++i)
+          results[i] = f(scratch, items[i]);
+      });
+  return results;
+}
+
+template <typename T, typename F>
+[[nodiscard]] auto parallel_map(std::span<const T> items, F &&f,
+                                const parallel_options &opts = {}) {
+  return parallel_map<detail::no_scratch>(
+      items, [&](detail::no_scratch &, const T &item) { return f(item); },
+      opts);
+}
+
+template <std::size_t N, std::size_t Capacity>
+void analyze_batch(std::span<const chord_instance<N>> chords,
+                   std::span<compact_analysis_result<Capacity>> out,
+                   const parallel_options &opts) {
+  static_assert(N <= 255, "Batch analysis supports up to 255 chord tones");
+  auto count = std::min(chords.size(), out.size());
+  auto per_block = opts;
+  per_block.grain = opts.grain ? opts.grain : 16;
+  detail::parallel_for<detail::chord_block<N>>(
+      (count + detail::batch_block - 1) / detail::batch_block, per_block,
+      [&](detail::chord_block<N> &block, std::size_t first, std::size_t last) {
+        for (auto b = first; b < last; ++b) {
+          auto begin = b * detail::batch_block;
+          auto len = std::min(detail::batch_block, count - begin);
+          detail::analyze_block(chords.subspan(begin, len),
+                                out.subspan(begin, len), block);
+        }
+      });
+}
+
+template <std::size_t N>
+[[nodiscard]] std::vector<compact_analysis_result<>>
+analyze_batch(std::span<const chord_instance<N>> chords,
+              const parallel_options &opts) {
+  std::vector<compact_analysis_result<>> out(chords.size());
+  analyze_batch(chords, std::span{out}, opts);
+  return out;
+}
+
+template <typename Sequence>
+[[nodiscard]] std::vector<std::string>
+parallel_names(std::span<const Sequence> tracks,
+               const parallel_options &opts = {}) {
+  return parallel_map(
+      tracks, [](const Sequence &track) { return track.names(); }, opts);
+}
+
+template <typename Sequence, std::size_t S>
+[[nodiscard]] std::vector<std::string>
+parallel_roman(std::span<const Sequence> tracks, const scale_instance<S> &key,
+               const parallel_options &opts = {}) {
+  return parallel_map(
+      tracks, [&](const Sequence &track) { return track.roman(key); }, opts);
+}
+
+}
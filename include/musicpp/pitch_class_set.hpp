@@ -0,0 +1,337 @@
+#pragma once
+#include "notes.hpp"
+#include "text.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <initializer_list>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace musicpp {
+
+namespace detail {
+inline constexpr std::uint16_t pcs_mask = 0xfffu;
+
+[[nodiscard]] constexpr std::uint16_t rotate_pcs(std::uint16_t set,
+                                                 int root) noexcept {
+  return static_cast<std::uint16_t>(((set >> root) | (set << (12 - root))) &
+                                    pcs_mask);
+}
+
+[[nodiscard]] constexpr std::uint16_t invert_pcs(std::uint16_t set) noexcept {
+  std::uint16_t result = set & 1u;
+  for (int pc = 1; pc < 12; ++pc) {
+    if (set & (1u << pc))
+      result |= static_cast<std::uint16_t>(1u << (12 - pc));
+  }
+  return result;
+}
+
+inline constexpr auto pcs_popcount = [] {
+  std::array<std::uint8_t, 4096> counts{};
+  for (unsigned set = 0; set < counts.size(); ++set)
+    counts[set] = static_cast<std::uint8_t>(std::popcount(set));
+  return counts;
+}();
+
+[[nodiscard]] constexpr std::uint16_t compute_prime_form(std::uint16_t set) noexcept {
+  auto best = set;
+  auto inverted = invert_pcs(set);
+  for (int t = 0; t < 12; ++t) {
+    best = std::min({best, rotate_pcs(set, t), rotate_pcs(inverted, t)});
+  }
+  return best;
+}
+
+struct set_class {
+  std::uint16_t prime;
+  std::array<std::uint8_t, 6> interval_vector;
+  std::uint8_t cardinality;
+  std::uint8_t ordinal;
+  std::uint8_t z_partner;
+  std::array<char, 6> name;
+  std::uint8_t name_size;
+};
+
+inline constexpr std::uint8_t no_z_partner = 0xff;
+
+consteval std::uint16_t prime(std::string_view digits) {
+  std::uint16_t set = 0;
+  for (char c : digits)
+    set |= static_cast<std::uint16_t>(1u << (c == 't' ? 10 : c == 'e' ? 11 : c - '0'));
+  return set;
+}
+
+// Forte's ordering for trichords through hexachords; the larger
+// cardinalities are numbered after their complements.
+inline constexpr auto forte_trichords = std::to_array<std::uint16_t>({
+    prime("012"), prime("013"), prime("014"), prime("015"), prime("016"),
+    prime("024"), prime("025"), prime("026"), prime("027"), prime("036"),
+    prime("037"), prime("048"),
+});
+
+inline constexpr auto forte_tetrachords = std::to_array<std::uint16_t>({
+    prime("0123"), prime("0124"), prime("0134"), prime("0125"), prime("0126"),
+    prime("0127"), prime("0145"), prime("0156"), prime("0167"), prime("0235"),
+    prime("0135"), prime("0236"), prime("0136"), prime("0237"), prime("0146"),
+    prime("0157"), prime("0347"), prime("0147"), prime("0148"), prime("0158"),
+    prime("0246"), prime("0247"), prime("0257"), prime("0248"), prime("0268"),
+    prime("0358"), prime("0258"), prime("0369"), prime("0137"),
+});
+
+inline constexpr auto forte_pentachords = std::to_array<std::uint16_t>({
+    prime("01234"), prime("01235"), prime("01245"), prime("01236"),
+    prime("01237"), prime("01256"), prime("01267"), prime("02346"),
+    prime("01246"), prime("01346"), prime("02347"), prime("01356"),
+    prime("01248"), prime("01257"), prime("01268"), prime("01347"),
+    prime("01348"), prime("01457"), prime("01367"), prime("01568"),
+    prime("01458"), prime("01478"), prime("02357"), prime("01357"),
+    prime("02358"), prime("02458"), prime("01358"), prime("02368"),
+    prime("01368"), prime("01468"), prime("01369"), prime("01469"),
+    prime("02468"), prime("02469"), prime("02479"), prime("01247"),
+    prime("03458"), prime("01258"),
+});
+
+inline constexpr auto forte_hexachords = std::to_array<std::uint16_t>({
+    prime("012345"), prime("012346"), prime("012356"), prime("012456"),
+    prime("012367"), prime("012567"), prime("012678"), prime("023457"),
+    prime("012357"), prime("013457"), prime("012457"), prime("012467"),
+    prime("013467"), prime("013458"), prime("012458"), prime("014568"),
+    prime("012478"), prime("012578"), prime("013478"), prime("014589"),
+    prime("023468"), prime("012468"), prime("023568"), prime("013468"),
+    prime("013568"), prime("013578"), prime("013469"), prime("013569"),
+    prime("023679"), prime("013679"), prime("014579"), prime("024579"),
+    prime("023579"), prime("013579"), prime("02468t"), prime("012347"),
+    prime("012348"), prime("012378"), prime("023458"), prime("012358"),
+    prime("012368"), prime("012369"), prime("012568"), prime("012569"),
+    prime("023469"), prime("012469"), prime("012479"), prime("012579"),
+    prime("013479"), prime("014679"),
+});
+
+inline constexpr std::size_t set_class_count = 224;
+
+struct set_class_tables {
+  std::array<set_class, set_class_count> classes{};
+  std::array<std::uint8_t, 4096> class_of{};
+};
+
+consteval set_class_tables make_set_class_tables() {
+  set_class_tables t;
+  std::size_t count = 0;
+  auto add = [&](std::uint16_t set, int ordinal) {
+    auto &c = t.classes[count++];
+    c.prime = compute_prime_form(set);
+    c.cardinality = pcs_popcount[c.prime];
+    c.ordinal = static_cast<std::uint8_t>(ordinal);
+    c.z_partner = no_z_partner;
+    for (int a = 0; a < 12; ++a) {
+      for (int b = a + 1; b < 12; ++b) {
+        if ((c.prime >> a & 1u) && (c.prime >> b & 1u))
+          ++c.interval_vector[static_cast<std::size_t>(std::min(b - a, 12 - b + a) - 1)];
+      }
+    }
+  };
+  auto complement = [](std::uint16_t set) {
+    return static_cast<std::uint16_t>(~set & pcs_mask);
+  };
+  auto add_list = [&](std::span<const std::uint16_t> list, bool complemented) {
+    for (std::size_t i = 0; i < list.size(); ++i)
+      add(complemented ? complement(list[i]) : list[i], static_cast<int>(i + 1));
+  };
+
+  add(0, 1);
+  add(1, 1);
+  for (int k = 1; k <= 6; ++k)
+    add(static_cast<std::uint16_t>(1u | 1u << k), k);
+  add_list(forte_trichords, false);
+  add_list(forte_tetrachords, false);
+  add_list(forte_pentachords, false);
+  add_list(forte_hexachords, false);
+  add_list(forte_pentachords, true);
+  add_list(forte_tetrachords, true);
+  add_list(forte_trichords, true);
+  for (int k = 1; k <= 6; ++k)
+    add(complement(static_cast<std::uint16_t>(1u | 1u << k)), k);
+  add(complement(1), 1);
+  add(pcs_mask, 1);
+  if (count != set_class_count)
+    throw "set-class catalogue has the wrong size";
+
+  std::array<std::uint8_t, 4096> by_prime{};
+  by_prime.fill(no_z_partner);
+  for (std::size_t i = 0; i < count; ++i) {
+    auto &c = t.classes[i];
+    if (by_prime[c.prime] != no_z_partner)
+      throw "set-class catalogue lists a class twice";
+    by_prime[c.prime] = static_cast<std::uint8_t>(i);
+    for (std::size_t j = 0; j < count; ++j) {
+      if (j != i && t.classes[j].cardinality == c.cardinality &&
+          t.classes[j].interval_vector == c.interval_vector)
+        c.z_partner = static_cast<std::uint8_t>(j);
+    }
+  }
+  for (auto &c : t.classes) {
+    auto out = c.name.begin();
+    out = write_int(out, c.cardinality);
+    *out++ = '-';
+    if (c.z_partner != no_z_partner)
+      *out++ = 'Z';
+    out = write_int(out, c.ordinal);
+    c.name_size = static_cast<std::uint8_t>(out - c.name.begin());
+  }
+  for (unsigned set = 0; set < 4096; ++set) {
+    auto index = by_prime[compute_prime_form(static_cast<std::uint16_t>(set))];
+    if (index == no_z_partner)
+      throw "set-class catalogue is missing a prime form";
+    t.class_of[set] = index;
+  }
+  return t;
+}
+
+inline constexpr auto set_classes = make_set_class_tables();
+}
+
+class pitch_class_set {
+public:
+  constexpr pitch_class_set() noexcept = default;
+  constexpr explicit pitch_class_set(std::uint16_t bits) noexcept
+      : m_bits(static_cast<std::uint16_t>(bits & detail::pcs_mask)) {}
+  constexpr pitch_class_set(std::initializer_list<int> pitch_classes) noexcept {
+    for (int pc : pitch_classes)
+      insert(pc);
+  }
+  constexpr explicit pitch_class_set(std::span<const note> notes) noexcept {
+    for (const auto &n : notes)
+      insert(n.get_pitch());
+  }
+
+  [[nodiscard]] constexpr std::uint16_t bits() const noexcept { return m_bits; }
+  [[nodiscard]] constexpr std::size_t size() const noexcept {
+    return detail::pcs_popcount[m_bits];
+  }
+  [[nodiscard]] constexpr bool empty() const noexcept { return m_bits == 0; }
+  [[nodiscard]] constexpr bool contains(int pc) const noexcept {
+    return m_bits & (1u << wrap(pc));
+  }
+
+  constexpr pitch_class_set &insert(int pc) noexcept {
+    m_bits = static_cast<std::uint16_t>(m_bits | (1u << wrap(pc)));
+    return *this;
+  }
+  constexpr pitch_class_set &erase(int pc) noexcept {
+    m_bits = static_cast<std::uint16_t>(m_bits & ~(1u << wrap(pc)));
+    return *this;
+  }
+
+  [[nodiscard]] constexpr pitch_class_set transpose(int semitones) const noexcept {
+    return pitch_class_set(detail::rotate_pcs(m_bits, (12 - wrap(semitones)) % 12));
+  }
+  [[nodiscard]] constexpr pitch_class_set invert(int axis = 0) const noexcept {
+    return pitch_class_set(detail::invert_pcs(m_bits)).transpose(axis);
+  }
+  [[nodiscard]] constexpr pitch_class_set complement() const noexcept {
+    return pitch_class_set(static_cast<std::uint16_t>(~m_bits));
+  }
+
+  [[nodiscard]] constexpr pitch_class_set prime_form() const noexcept {
+    return pitch_class_set(set_class().prime);
+  }
+  [[nodiscard]] constexpr std::string_view forte_name() const noexcept {
+    const auto &c = set_class();
+    return {c.name.data(), c.name_size};
+  }
+  [[nodiscard]] constexpr int forte_ordinal() const noexcept {
+    return set_class().ordinal;
+  }
+  [[nodiscard]] constexpr std::array<std::uint8_t, 6>
+  interval_vector() const noexcept {
+    return set_class().interval_vector;
+  }
+  [[nodiscard]] constexpr std::optional<pitch_class_set>
+  z_correspondent() const noexcept {
+    auto partner = set_class().z_partner;
+    if (partner == detail::no_z_partner)
+      return std::nullopt;
+    return pitch_class_set(detail::set_classes.classes[partner].prime);
+  }
+  [[nodiscard]] constexpr bool
+  same_set_class(const pitch_class_set &other) const noexcept {
+    return class_index() == other.class_index();
+  }
+  [[nodiscard]] constexpr bool
+  is_z_related(const pitch_class_set &other) const noexcept {
+    return set_class().z_partner == other.class_index();
+  }
+
+  [[nodiscard]] friend constexpr pitch_class_set
+  operator|(pitch_class_set a, pitch_class_set b) noexcept {
+    return pitch_class_set(static_cast<std::uint16_t>(a.m_bits | b.m_bits));
+  }
+  [[nodiscard]] friend constexpr pitch_class_set
+  operator&(pitch_class_set a, pitch_class_set b) noexcept {
+    return pitch_class_set(static_cast<std::uint16_t>(a.m_bits & b.m_bits));
+  }
+  [[nodiscard]] friend constexpr pitch_class_set
+  operator^(pitch_class_set a, pitch_class_set b) noexcept {
+    return pitch_class_set(static_cast<std::uint16_t>(a.m_bits ^ b.m_bits));
+  }
+  [[nodiscard]] friend constexpr pitch_class_set
+  operator-(pitch_class_set a, pitch_class_set b) noexcept {
+    return pitch_class_set(static_cast<std::uint16_t>(a.m_bits & ~b.m_bits));
+  }
+
+  constexpr bool operator==(const pitch_class_set &) const noexcept = default;
+
+  static constexpr std::size_t max_chars = 27;
+
+  template <typename Out> constexpr Out write_to(Out out) const {
+    *out++ = '{';
+    bool first = true;
+    for (int pc = 0; pc < 12; ++pc) {
+      if (!contains(pc))
+        continue;
+      if (!first)
+        *out++ = ',';
+      first = false;
+      out = detail::write_int(out, pc);
+    }
+    *out++ = '}';
+    return out;
+  }
+
+  [[nodiscard]] std::string str() const {
+    return detail::to_text<pitch_class_set, max_chars>(*this);
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const pitch_class_set &s) {
+    std::array<char, max_chars> buffer{};
+    return os << std::string_view(buffer.data(), s.write_to(buffer.data()));
+  }
+
+private:
+  [[nodiscard]] static constexpr int wrap(int pc) noexcept {
+    return (pc % 12 + 12) % 12;
+  }
+  [[nodiscard]] constexpr std::uint8_t class_index() const noexcept {
+    return detail::set_classes.class_of[m_bits];
+  }
+  [[nodiscard]] constexpr const detail::set_class &set_class() const noexcept {
+    return detail::set_classes.classes[class_index()];
+  }
+
+  std::uint16_t m_bits{0};
+};
+
+}
+
+template <>
+struct std::formatter<musicpp::pitch_class_set>
+    : musicpp::detail::text_formatter<musicpp::pitch_class_set,
+                                      musicpp::pitch_class_set::max_chars> {};
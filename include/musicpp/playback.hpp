@@ -0,0 +1,368 @@
+#pragma once
+#include "chord_sequence.hpp"
+#include "melody.hpp"
+#include "notes.hpp"
+#include "tempo_map.hpp"
+#include "timing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace musicpp {
+
+enum class playback_kind : std::uint8_t { note_off, note_on };
+
+struct playback_event {
+  double time{0.0};
+  note pitch{};
+  playback_kind kind{playback_kind::note_on};
+
+  constexpr bool operator==(const playback_event &) const noexcept = default;
+};
+
+namespace detail {
+// Single-producer/single-consumer ring. Each side caches the other side's
+// index and only reloads it when the ring looks full (or empty), so the
+// common push or pop touches one shared cache line.
+template <typename T> class spsc_ring {
+public:
+  explicit spsc_ring(std::size_t capacity)
+      : m_mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+        m_slots(std::make_unique<T[]>(m_mask + 1)) {}
+
+  bool try_push(const T &value) noexcept {
+    const auto tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head_cache > m_mask) {
+      m_head_cache = m_head.load(std::memory_order_acquire);
+      if (tail - m_head_cache > m_mask)
+        return false;
+    }
+    m_slots[tail & m_mask] = value;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(T &value) noexcept {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail_cache) {
+      m_tail_cache = m_tail.load(std::memory_order_acquire);
+      if (head == m_tail_cache)
+        return false;
+    }
+    value = m_slots[head & m_mask];
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  [[nodiscard]] std::size_t capacity() const noexcept { return m_mask + 1; }
+
+  // Drops anything left in the ring. Only valid while neither side runs.
+  void reset() noexcept {
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_tail_cache = 0;
+    m_head_cache = 0;
+  }
+
+private:
+  const std::size_t m_mask;
+  std::unique_ptr<T[]> m_slots;
+  alignas(64) std::atomic<std::size_t> m_head{0};
+  std::size_t m_tail_cache{0};
+  alignas(64) std::atomic<std::size_t> m_tail{0};
+  std::size_t m_head_cache{0};
+};
+
+// Note-on/off events for a stream of (duration, notes, rest, tied) entries.
+// A tied entry keeps any pitch the next entry repeats sounding, so that
+// pitch gets neither an off nor a fresh on at the join.
+class playback_builder {
+public:
+  void add(duration dur, std::span<const note> pitches, bool is_rest, bool is_tied) {
+    m_entries.push_back({m_onset, m_notes.size(), pitches.size(), is_rest, is_tied});
+    m_notes.insert(m_notes.end(), pitches.begin(), pitches.end());
+    m_onset += dur;
+  }
+
+  template <typename Seconds>
+  [[nodiscard]] std::vector<playback_event> build(Seconds seconds) const {
+    std::vector<double> times(m_entries.size() + 1);
+    for (std::size_t i = 0; i < m_entries.size(); ++i)
+      times[i] = seconds(m_entries[i].onset);
+    times.back() = seconds(m_onset);
+
+    std::vector<playback_event> out;
+    out.reserve(m_notes.size() * 2);
+    for (std::size_t i = 0; i < m_entries.size(); ++i) {
+      const auto &e = m_entries[i];
+      if (e.is_rest)
+        continue;
+      const entry *prev = i > 0 ? &m_entries[i - 1] : nullptr;
+      const entry *next = i + 1 < m_entries.size() ? &m_entries[i + 1] : nullptr;
+      for (const auto &n : notes_of(e)) {
+        if (!(prev && prev->is_tied && !prev->is_rest && contains(*prev, n)))
+          out.push_back({times[i], n, playback_kind::note_on});
+        if (!(e.is_tied && next && !next->is_rest && contains(*next, n)))
+          out.push_back({times[i + 1], n, playback_kind::note_off});
+      }
+    }
+    std::stable_sort(out.begin(), out.end(), [](const auto &a, const auto &b) {
+      return a.time < b.time || (a.time == b.time && a.kind < b.kind);
+    });
+    return out;
+  }
+
+private:
+  struct entry {
+    wide_duration onset;
+    std::size_t first;
+    std::size_t count;
+    bool is_rest;
+    bool is_tied;
+  };
+
+  [[nodiscard]] std::span<const note> notes_of(const entry &e) const noexcept {
+    return std::span<const note>(m_notes).subspan(e.first, e.count);
+  }
+
+  [[nodiscard]] bool contains(const entry &e, const note &n) const noexcept {
+    auto ns = notes_of(e);
+    return std::find(ns.begin(), ns.end(), n) != ns.end();
+  }
+
+  std::vector<entry> m_entries;
+  std::vector<note> m_notes;
+  wide_duration m_onset;
+};
+
+template <std::size_t N> void add_events(playback_builder &b, const melody<N> &m) {
+  for (const auto &ev : m)
+    b.add(ev.dur, std::span<const note>(&ev.pitch, 1), ev.is_rest, ev.is_tied);
+}
+
+template <typename... Events>
+void add_events(playback_builder &b, const chord_sequence<Events...> &seq) {
+  seq.for_each([&](const auto &ev) {
+    b.add(ev.dur, ev.chord.notes, ev.is_rest, ev.is_tied);
+  });
+}
+}
+
+// Note-on/off events in seconds, sorted by time with offs ahead of ons at
+// the same instant so repeated notes retrigger.
+template <typename Stream>
+[[nodiscard]] std::vector<playback_event> playback_events(const Stream &stream,
+                                                          tempo t) {
+  detail::playback_builder b;
+  detail::add_events(b, stream);
+  const double whole = t.seconds(durations::whole);
+  return b.build([whole](wide_duration at) { return whole * detail::whole_notes(at); });
+}
+
+template <typename Stream>
+[[nodiscard]] std::vector<playback_event> playback_events(const Stream &stream,
+                                                          const tempo_map &map) {
+  detail::playback_builder b;
+  detail::add_events(b, stream);
+  return b.build([&map](wide_duration at) { return map.seconds(at); });
+}
+
+struct playback_options {
+  std::size_t queue_capacity{1024};
+  std::chrono::microseconds lookahead{20000};
+  std::chrono::microseconds spin{300};
+};
+
+// Lateness of delivered events relative to their due time.
+struct playback_stats {
+  std::size_t count{0};
+  std::chrono::nanoseconds min{std::chrono::nanoseconds::max()};
+  std::chrono::nanoseconds max{std::chrono::nanoseconds::min()};
+  std::chrono::nanoseconds total{0};
+
+  void add(std::chrono::nanoseconds late) noexcept {
+    ++count;
+    min = std::min(min, late);
+    max = std::max(max, late);
+    total += late;
+  }
+
+  [[nodiscard]] std::chrono::nanoseconds mean() const noexcept {
+    return count ? total / static_cast<std::int64_t>(count)
+                 : std::chrono::nanoseconds{0};
+  }
+};
+
+// Sink that keeps every delivered event with the time it went out.
+class playback_recorder {
+public:
+  struct record {
+    playback_event event;
+    std::chrono::steady_clock::time_point delivered;
+  };
+
+  explicit playback_recorder(std::size_t reserve = 0) { m_records.reserve(reserve); }
+
+  void operator()(const playback_event &ev, std::chrono::steady_clock::time_point at) {
+    m_records.push_back({ev, at});
+  }
+
+  [[nodiscard]] const std::vector<record> &records() const noexcept {
+    return m_records;
+  }
+
+private:
+  std::vector<record> m_records;
+};
+
+// Plays timestamped events on a consumer thread driven by steady_clock.
+// A producer thread feeds the lock-free queue no further than `lookahead`
+// ahead of the due time; the consumer sleeps until just before each event
+// and spins the last `spin` microseconds. The sink is called on the
+// consumer thread as sink(event, delivery_time). When playback stops, every
+// note still sounding gets a note_off, so a synth is never left hanging.
+template <typename Sink> class playback_scheduler {
+public:
+  using clock = std::chrono::steady_clock;
+
+  explicit playback_scheduler(Sink sink, playback_options options = {})
+      : m_sink(std::move(sink)), m_options(options),
+        m_queue(options.queue_capacity) {}
+
+  playback_scheduler(const playback_scheduler &) = delete;
+  playback_scheduler &operator=(const playback_scheduler &) = delete;
+
+  ~playback_scheduler() { stop(); }
+
+  void start(std::vector<playback_event> events) {
+    if (m_producer.joinable() || m_consumer.joinable())
+      throw std::logic_error("playback is already running");
+    if (!std::is_sorted(events.begin(), events.end(),
+                        [](const auto &a, const auto &b) { return a.time < b.time; }))
+      throw std::invalid_argument("playback events must be sorted by time");
+    m_events = std::move(events);
+    m_queue.reset();
+    m_sounding.clear();
+    m_sounding.reserve(m_events.size());
+    m_stats = {};
+    m_stop.store(false, std::memory_order_relaxed);
+    m_produced.store(false, std::memory_order_relaxed);
+    m_start = clock::now() + m_options.lookahead;
+    m_consumer = std::thread([this] { consume(); });
+    m_producer = std::thread([this] { produce(); });
+  }
+
+  void wait() {
+    if (m_producer.joinable())
+      m_producer.join();
+    if (m_consumer.joinable())
+      m_consumer.join();
+  }
+
+  void stop() {
+    m_stop.store(true, std::memory_order_relaxed);
+    wait();
+  }
+
+  [[nodiscard]] clock::time_point start_time() const noexcept { return m_start; }
+
+  // Valid once wait() or stop() has returned.
+  [[nodiscard]] const playback_stats &stats() const noexcept { return m_stats; }
+  [[nodiscard]] Sink &sink() noexcept { return m_sink; }
+
+private:
+  [[nodiscard]] clock::time_point due(const playback_event &ev) const noexcept {
+    return m_start + std::chrono::duration_cast<clock::duration>(
+                         std::chrono::duration<double>(ev.time));
+  }
+
+  // Sleeps in short slices so a stop request is noticed promptly.
+  [[nodiscard]] bool sleep_until(clock::time_point t) const {
+    constexpr auto slice = std::chrono::milliseconds(5);
+    for (auto now = clock::now(); now < t; now = clock::now()) {
+      if (m_stop.load(std::memory_order_relaxed))
+        return false;
+      std::this_thread::sleep_until(std::min(t, now + slice));
+    }
+    return !m_stop.load(std::memory_order_relaxed);
+  }
+
+  void produce() {
+    for (const auto &ev : m_events) {
+      if (!sleep_until(due(ev) - m_options.lookahead))
+        break;
+      while (!m_queue.try_push(ev)) {
+        if (m_stop.load(std::memory_order_relaxed))
+          break;
+        std::this_thread::yield();
+      }
+    }
+    m_produced.store(true, std::memory_order_release);
+  }
+
+  void consume() {
+    playback_event ev;
+    while (!m_stop.load(std::memory_order_relaxed)) {
+      if (!m_queue.try_pop(ev)) {
+        if (!m_produced.load(std::memory_order_acquire)) {
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+          continue;
+        }
+        if (!m_queue.try_pop(ev))
+          break;
+      }
+      const auto when = due(ev);
+      if (!sleep_until(when - m_options.spin))
+        break;
+      auto now = clock::now();
+      while (now < when)
+        now = clock::now();
+      m_sink(ev, now);
+      m_stats.add(now - when);
+      track(ev);
+    }
+    release();
+  }
+
+  void track(const playback_event &ev) {
+    if (ev.kind == playback_kind::note_on) {
+      m_sounding.push_back(ev.pitch);
+      return;
+    }
+    auto it = std::find(m_sounding.begin(), m_sounding.end(), ev.pitch);
+    if (it != m_sounding.end())
+      m_sounding.erase(it);
+  }
+
+  // Sends a note_off for every note_on delivered without one, latest first.
+  void release() {
+    const auto now = clock::now();
+    const double at = std::max(0.0, std::chrono::duration<double>(now - m_start).count());
+    for (auto it = m_sounding.rbegin(); it != m_sounding.rend(); ++it)
+      m_sink(playback_event{at, *it, playback_kind::note_off}, now);
+    m_sounding.clear();
+  }
+
+  Sink m_sink;
+  playback_options m_options;
+  detail::spsc_ring<playback_event> m_queue;
+  std::vector<playback_event> m_events;
+  std::vector<note> m_sounding;
+  playback_stats m_stats;
+  clock::time_point m_start;
+  std::atomic<bool> m_stop{false};
+  std::atomic<bool> m_produced{false};
+  std::thread m_producer;
+  std::thread m_consumer;
+};
+
+}
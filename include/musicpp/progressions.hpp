@@ -104,6 +104,12 @@ template <typename... Steps> struct progression {
     return realize(key).names();
   }
 
+  template <std::size_t S>
+  [[nodiscard]] constexpr auto
+  names_ct(const scale_instance<S> &key) const noexcept {
+    return realize(key).names_ct();
+  }
+
   template <std::size_t S>
   [[nodiscard]] std::string roman(const scale_instance<S> &key) const {
     return realize(key).roman(key);
@@ -0,0 +1,238 @@
+#pragma once
+#include "duration.hpp"
+#include "melody.hpp"
+#include "notes.hpp"
+#include "timing.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace musicpp {
+
+struct performed_note {
+  double onset{0.0};
+  double offset{0.0};
+  note pitch{};
+};
+
+struct quantize_options {
+  int subdivisions{4};          // duple grid steps per beat
+  int tuplet_subdivisions{3};   // tuplet grid steps per beat; 0 disables it
+  double tuplet_penalty{0.004}; // per beat, in squared beats
+  double switch_penalty{0.002}; // per change between duple and tuplet beats
+  bool split_unnotatable{true}; // tie values no single note value can show
+};
+
+namespace detail {
+// Every single note value from a whole down to a 32nd, plain, dotted and
+// as a triplet, longest first.
+inline constexpr auto notatable_durations = [] {
+  std::array<duration, 18> table{};
+  std::size_t n = 0;
+  for (int den = 1; den <= 32; den *= 2) {
+    duration base{1, den};
+    table[n++] = base.dotted();
+    table[n++] = base;
+    table[n++] = base.triplet();
+  }
+  std::sort(table.begin(), table.end(),
+            [](duration a, duration b) { return b < a; });
+  return table;
+}();
+
+// What a single note value can show: the table above, plus multiples of the
+// tuplet grid's step shorter than a beat (such as 3/20 in a quintuplet beat).
+struct notation_grid {
+  wide_duration tuplet_step{0, 1};
+  std::int64_t tuplet_count{0};
+
+  [[nodiscard]] constexpr bool contains(wide_duration d) const noexcept {
+    if (std::find(notatable_durations.begin(), notatable_durations.end(), d) !=
+        notatable_durations.end())
+      return true;
+    if (tuplet_count == 0)
+      return false;
+    auto k = d.count_of(tuplet_step);
+    return k > 0 && k < tuplet_count && tuplet_step * k == d;
+  }
+
+  // Longest value this grid can show that is shorter than `left`.
+  [[nodiscard]] constexpr wide_duration longest_below(wide_duration left) const noexcept {
+    wide_duration best;
+    auto it = std::find_if(notatable_durations.begin(), notatable_durations.end(),
+                           [&](duration d) { return d < left; });
+    if (it != notatable_durations.end())
+      best = *it;
+    if (tuplet_count != 0) {
+      auto k = std::min(left.count_of(tuplet_step), tuplet_count - 1);
+      if (tuplet_step * k == left)
+        --k;
+      if (k > 0 && best < tuplet_step * k)
+        best = tuplet_step * k;
+    }
+    return best;
+  }
+};
+
+// Appends a value of `length` split greedily into the longest values `grid`
+// can show, tied together; a remainder none covers is kept as it is.
+inline void append_notatable(std::vector<melody_event> &out, melody_event ev,
+                             wide_duration length, const notation_grid &grid) {
+  while (!grid.contains(length)) {
+    auto part = grid.longest_below(length);
+    if (part == wide_duration{})
+      break;
+    out.push_back({ev.pitch, part.narrow(), ev.is_rest, !ev.is_rest});
+    length -= part;
+  }
+  ev.dur = length.narrow();
+  out.push_back(ev);
+}
+}
+
+// Snaps performed notes to a beat grid and returns a monophonic line of
+// notes and rests starting at the first downbeat (time 0).
+//
+// Every onset and offset is measured in beats of `ts`. Each beat picks the
+// duple grid or the tuplet grid by total squared snapping error plus
+// penalties; a Viterbi pass over the beats, with a cost for switching grid
+// between neighbours, keeps tuplet groups together. The pass is linear in
+// the number of beats, with two states per beat.
+//
+// With split_unnotatable, values are tied across every barline and then
+// split greedily, longest first, into single values; beat groupings inside
+// a bar (say, not letting a note hide beat 3 of 4/4) are not enforced.
+[[nodiscard]] inline std::vector<melody_event>
+quantize(std::span<const performed_note> notes, tempo t, time_signature ts,
+         const quantize_options &options = {}) {
+  if (options.subdivisions <= 0 || options.tuplet_subdivisions < 0)
+    throw std::invalid_argument("grid subdivisions must be positive");
+  std::vector<melody_event> out;
+  if (notes.empty())
+    return out;
+
+  const double beat_seconds = t.seconds(ts.beat_duration());
+  const std::array<int, 2> steps{options.subdivisions,
+                                 options.tuplet_subdivisions ? options.tuplet_subdivisions
+                                                             : options.subdivisions};
+
+  struct point {
+    double beats;
+    std::size_t beat;
+  };
+  std::vector<point> points;
+  points.reserve(notes.size() * 2);
+  std::size_t beat_count = 0;
+  for (const auto &n : notes) {
+    for (double s : {n.onset, std::max(n.offset, n.onset)}) {
+      const double x = std::max(s, 0.0) / beat_seconds;
+      const auto beat = static_cast<std::size_t>(x);
+      points.push_back({x, beat});
+      beat_count = std::max(beat_count, beat + 1);
+    }
+  }
+
+  // Grid steps from the start of the point's beat, 0 to steps[grid].
+  auto snap = [&](const point &p, std::size_t grid) {
+    return std::lround((p.beats - static_cast<double>(p.beat)) * steps[grid]);
+  };
+
+  std::vector<std::array<double, 2>> local(beat_count, {0.0, 0.0});
+  for (const auto &p : points) {
+    for (std::size_t g = 0; g < 2; ++g) {
+      const double err = p.beats - static_cast<double>(p.beat) -
+                         static_cast<double>(snap(p, g)) / steps[g];
+      local[p.beat][g] += err * err;
+    }
+  }
+
+  std::vector<std::uint8_t> from(beat_count);
+  std::array<double, 2> cost{local[0][0], local[0][1] + options.tuplet_penalty};
+  for (std::size_t b = 1; b < beat_count; ++b) {
+    std::array<double, 2> next{};
+    std::uint8_t back = 0;
+    for (int g = 0; g < 2; ++g) {
+      const auto gi = static_cast<std::size_t>(g);
+      const double stay = cost[gi];
+      const double move = cost[1 - gi] + options.switch_penalty;
+      back = static_cast<std::uint8_t>(back | (move < stay) << g);
+      next[gi] = std::min(stay, move) + local[b][gi] + (g ? options.tuplet_penalty : 0.0);
+    }
+    from[b] = back;
+    cost = next;
+  }
+  if (!options.tuplet_subdivisions)
+    cost[1] = cost[0] + 1.0;
+
+  std::vector<std::uint8_t> grid(beat_count);
+  std::size_t g = cost[1] < cost[0] ? 1 : 0;
+  for (std::size_t b = beat_count; b-- > 0;) {
+    grid[b] = static_cast<std::uint8_t>(g);
+    g = (from[b] >> g & 1u) ? 1 - g : g;
+  }
+
+  const wide_duration beat_len{ts.beat_duration()};
+  auto place = [&](const point &p) {
+    const std::int64_t s = steps[grid[p.beat]];
+    const auto at = static_cast<std::int64_t>(p.beat) * s + snap(p, grid[p.beat]);
+    return wide_duration{at * beat_len.num, s * beat_len.den};
+  };
+
+  std::vector<std::size_t> order(notes.size());
+  for (std::size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+    return notes[a].onset < notes[b].onset;
+  });
+
+  const wide_duration bar_len{ts.bar_duration()};
+  detail::notation_grid notation;
+  if (options.tuplet_subdivisions) {
+    notation.tuplet_step = wide_duration{beat_len.num, beat_len.den * options.tuplet_subdivisions};
+    notation.tuplet_count = options.tuplet_subdivisions;
+  }
+  auto emit = [&](note pitch, bool is_rest, wide_duration at, wide_duration length) {
+    if (!options.split_unnotatable) {
+      out.push_back({pitch, length.narrow(), is_rest, false});
+      return;
+    }
+    while (true) {
+      auto to_bar = bar_len * (at.count_of(bar_len) + 1) - at;
+      auto last = !(to_bar < length);
+      auto part = last ? length : to_bar;
+      detail::append_notatable(out, {pitch, {}, is_rest, !last && !is_rest}, part, notation);
+      if (last)
+        return;
+      at += part;
+      length -= part;
+    }
+  };
+
+  wide_duration cursor;
+  for (std::size_t k = 0; k < order.size(); ++k) {
+    const auto i = order[k];
+    const auto &start = points[2 * i];
+    auto on = place(start);
+    auto off = place(points[2 * i + 1]);
+    if (!(off > on))
+      off = on + wide_duration{beat_len.num, beat_len.den * steps[grid[start.beat]]};
+    if (on < cursor)
+      on = cursor;
+    if (k + 1 < order.size())
+      off = std::min(off, place(points[2 * order[k + 1]]));
+    if (!(off > on))
+      continue;
+    if (on > cursor)
+      emit(note{}, true, cursor, on - cursor);
+    emit(notes[i].pitch, false, on, off - on);
+    cursor = off;
+  }
+  return out;
+}
+
+}
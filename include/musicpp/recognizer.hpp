@@ -0,0 +1,177 @@
+#pragma once
+#include "chord_dictionary.hpp"
+#include "chords.hpp"
+#include "notes.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace musicpp {
+
+namespace detail {
+struct key_set {
+  std::array<std::uint64_t, 2> words{};
+
+  constexpr void set(std::size_t key) noexcept {
+    words[key >> 6] |= std::uint64_t{1} << (key & 63);
+  }
+  constexpr void reset(std::size_t key) noexcept {
+    words[key >> 6] &= ~(std::uint64_t{1} << (key & 63));
+  }
+  [[nodiscard]] constexpr bool empty() const noexcept {
+    return (words[0] | words[1]) == 0;
+  }
+  [[nodiscard]] constexpr std::size_t count() const noexcept {
+    return static_cast<std::size_t>(std::popcount(words[0]) +
+                                    std::popcount(words[1]));
+  }
+  [[nodiscard]] constexpr std::size_t lowest() const noexcept {
+    return words[0] ? static_cast<std::size_t>(std::countr_zero(words[0]))
+                    : 64 + static_cast<std::size_t>(std::countr_zero(words[1]));
+  }
+  [[nodiscard]] constexpr key_set operator&(const key_set &other) const noexcept {
+    return {{words[0] & other.words[0], words[1] & other.words[1]}};
+  }
+};
+
+inline constexpr std::size_t key_count = 128;
+
+inline constexpr auto pitch_class_keys = [] {
+  std::array<key_set, 12> masks{};
+  for (std::size_t key = 0; key < key_count; ++key)
+    masks[key % 12].set(key);
+  return masks;
+}();
+
+[[nodiscard]] constexpr bool same_chord(const compact_analysis &a,
+                                        const compact_analysis &b) noexcept {
+  return a.info == b.info && a.omitted == b.omitted &&
+         a.inversion == b.inversion &&
+         a.root.get_fifth() == b.root.get_fifth() &&
+         a.bass.has_value() == b.bass.has_value() &&
+         (!a.bass || a.bass->get_fifth() == b.bass->get_fifth());
+}
+}
+
+class chord_recognizer {
+public:
+  chord_recognizer() = default;
+  explicit chord_recognizer(chord_dictionary dict)
+      : m_dict(std::move(dict)), m_table(m_dict.table()),
+        m_result(m_dict.max_interpretations()) {}
+
+  bool note_on(const note &n) noexcept {
+    auto midi = n.get_midi_pitch();
+    if (midi < 0)
+      return false;
+    auto key = static_cast<std::size_t>(midi);
+    if (m_held[key] != 0) {
+      if (m_held[key] < UINT8_MAX)
+        ++m_held[key];
+      return false;
+    }
+    m_held[key] = 1;
+    m_spelling[key] = n;
+    auto pc = key % 12;
+    bool affects_voicing =
+        m_pitch_class_count[pc]++ == 0 ||
+        (m_sounding & detail::pitch_class_keys[pc]).lowest() > key;
+    m_sounding.set(key);
+    m_present |= static_cast<std::uint16_t>(1u << pc);
+    return affects_voicing && recognize();
+  }
+
+  bool note_off(const note &n) noexcept {
+    auto midi = n.get_midi_pitch();
+    if (midi < 0)
+      return false;
+    auto key = static_cast<std::size_t>(midi);
+    if (m_held[key] == 0 || --m_held[key] != 0)
+      return false;
+    auto pc = key % 12;
+    bool affects_voicing =
+        (m_sounding & detail::pitch_class_keys[pc]).lowest() == key;
+    m_sounding.reset(key);
+    if (--m_pitch_class_count[pc] == 0)
+      m_present &= static_cast<std::uint16_t>(~(1u << pc));
+    return affects_voicing && recognize();
+  }
+
+  bool all_notes_off() noexcept {
+    m_held.fill(0);
+    m_pitch_class_count.fill(0);
+    m_sounding = {};
+    m_present = 0;
+    return recognize();
+  }
+
+  [[nodiscard]] std::optional<compact_analysis> current() const noexcept {
+    if (m_result.empty())
+      return std::nullopt;
+    return m_result[0];
+  }
+  [[nodiscard]] const compact_analysis_result<std::dynamic_extent> &
+  interpretations() const noexcept {
+    return m_result;
+  }
+  [[nodiscard]] std::uint16_t pitch_classes() const noexcept {
+    return m_present;
+  }
+  [[nodiscard]] std::optional<note> bass() const noexcept {
+    if (m_sounding.empty())
+      return std::nullopt;
+    return m_spelling[m_sounding.lowest()];
+  }
+  [[nodiscard]] std::size_t sounding() const noexcept {
+    return m_sounding.count();
+  }
+
+private:
+  bool recognize() noexcept {
+    auto previous = current();
+    m_result.clear();
+    if (!m_sounding.empty()) {
+      std::array<std::size_t, 12> roots{};
+      std::size_t root_count = 0;
+      for (std::size_t pc = 0; pc < 12; ++pc) {
+        if (!(m_present & (1u << pc)))
+          continue;
+        auto key = (m_sounding & detail::pitch_class_keys[pc]).lowest();
+        auto pos = root_count++;
+        while (pos > 0 && roots[pos - 1] > key) {
+          roots[pos] = roots[pos - 1];
+          --pos;
+        }
+        roots[pos] = key;
+      }
+
+      const auto &lowest = m_spelling[roots[0]];
+      for (std::size_t k = 0; k < root_count; ++k) {
+        const auto &root = m_spelling[roots[k]];
+        for (const auto &m :
+             m_table[detail::rotate_pcs(m_present, static_cast<int>(roots[k] % 12))])
+          m_result.insert(
+              detail::build_analysis(root, m, m_table.info(m), lowest));
+      }
+    }
+    auto next = current();
+    if (previous.has_value() != next.has_value())
+      return true;
+    return previous && !detail::same_chord(*previous, *next);
+  }
+
+  chord_dictionary m_dict;
+  detail::match_table m_table{detail::builtin_matches};
+  std::array<note, detail::key_count> m_spelling{};
+  std::array<std::uint8_t, detail::key_count> m_held{};
+  std::array<std::uint8_t, 12> m_pitch_class_count{};
+  detail::key_set m_sounding;
+  std::uint16_t m_present{0};
+  compact_analysis_result<std::dynamic_extent> m_result{detail::max_interpretations};
+};
+
+}
@@ -144,6 +144,10 @@ template <std::size_t N> struct scale_instance {
     return result;
   }
 
+  template <typename Out> constexpr Out write_to(Out out) const {
+    return detail::write_joined(out, notes, " ");
+  }
+
   friend std::ostream &operator<<(std::ostream &os,
                                   const scale_instance &s) {
     for (std::size_t i = 0; i < N; ++i) {
@@ -215,14 +219,4 @@ constexpr auto bebop_major =
 
 template <std::size_t N>
 struct std::formatter<musicpp::scale_instance<N>>
-    : std::formatter<std::string> {
-  auto format(const musicpp::scale_instance<N> &s, auto &ctx) const {
-    std::string str;
-    for (std::size_t i = 0; i < N; ++i) {
-      if (i > 0)
-        str += ' ';
-      str += s[i].str();
-    }
-    return std::formatter<std::string>::format(str, ctx);
-  }
-};
+    : musicpp::detail::text_formatter<musicpp::scale_instance<N>> {};
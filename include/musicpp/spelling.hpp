@@ -0,0 +1,178 @@
+#pragma once
+#include "melody.hpp"
+#include "notes.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace musicpp {
+
+struct spelling_options {
+  std::size_t window{8};
+  int accidental_cost{2};
+  int key_cost{1};
+  int leap_cost{2};
+};
+
+namespace detail {
+inline constexpr int spelling_key_min = -7;
+inline constexpr int spelling_key_count = 15;
+inline constexpr std::size_t spelling_candidates = 3;
+
+[[nodiscard]] constexpr int accidental_count(int fifth) noexcept {
+  int shifted = fifth + 1;
+  int accidentals = (shifted >= 0) ? shifted / 7 : (shifted - 6) / 7;
+  return accidentals < 0 ? -accidentals : accidentals;
+}
+
+// key_contains[pc][key]: whether the major key with tonic fifth
+// key + spelling_key_min has pc in its diatonic set.
+inline constexpr auto key_contains = [] {
+  std::array<std::array<int, spelling_key_count>, 12> table{};
+  for (int key = 0; key < spelling_key_count; ++key) {
+    int tonic = key + spelling_key_min;
+    for (int fifth = tonic - 1; fifth <= tonic + 5; ++fifth)
+      table[static_cast<std::size_t>(fifth_pitch_classes[static_cast<std::uint8_t>(fifth)])]
+           [static_cast<std::size_t>(key)] = 1;
+  }
+  return table;
+}();
+
+// Spellings of each pitch class from double flats to double sharps,
+// nearest to C on the line of fifths first. The flat side of Db and Ab
+// would be a triple flat, so that slot repeats the nearest spelling.
+inline constexpr auto pitch_class_spellings = [] {
+  std::array<std::array<std::int8_t, spelling_candidates>, 12> table{};
+  for (int pc = 0; pc < 12; ++pc) {
+    int fifth = (pc * 7) % 12;
+    if (fifth > 6)
+      fifth -= 12;
+    auto within = [fifth](int f) { return accidental_count(f) <= 2 ? f : fifth; };
+    table[static_cast<std::size_t>(pc)] = {static_cast<std::int8_t>(fifth),
+                                           static_cast<std::int8_t>(within(fifth - 12)),
+                                           static_cast<std::int8_t>(within(fifth + 12))};
+  }
+  return table;
+}();
+
+class key_window {
+public:
+  constexpr void add(int pc) noexcept { update(pc, 1); }
+  constexpr void remove(int pc) noexcept { update(pc, -1); }
+
+  // Major key (as tonic fifth) whose diatonic set covers the most notes
+  // in the window; ties keep the previous key, then favour fewer accidentals.
+  [[nodiscard]] constexpr int best(int previous) const noexcept {
+    int best_key = 0;
+    int best_rank = -1;
+    for (int key = 0; key < spelling_key_count; ++key) {
+      int tonic = key + spelling_key_min;
+      int rank = m_scores[static_cast<std::size_t>(key)] * 32 +
+                 (tonic == previous ? 16 : 0) + 8 - (tonic < 0 ? -tonic : tonic);
+      best_key = rank > best_rank ? tonic : best_key;
+      best_rank = std::max(rank, best_rank);
+    }
+    return best_key;
+  }
+
+private:
+  constexpr void update(int pc, int delta) noexcept {
+    const auto &contains = key_contains[static_cast<std::size_t>(pc)];
+    for (std::size_t key = 0; key < m_scores.size(); ++key)
+      m_scores[key] += contains[key] * delta;
+  }
+
+  std::array<int, spelling_key_count> m_scores{};
+};
+
+[[nodiscard]] constexpr note respell(const note &n, int fifth) noexcept {
+  int shift = (fifth - n.get_fifth()) / 12;
+  return note(static_cast<std::int8_t>(fifth),
+              static_cast<std::int8_t>(n.get_octave() - shift * 7));
+}
+}
+
+constexpr void spell_notes(std::span<note> notes,
+                           const spelling_options &options = {}) {
+  const auto count = notes.size();
+  if (count == 0)
+    return;
+
+  using costs = std::array<int, detail::spelling_candidates>;
+  std::vector<std::uint8_t> from(count);
+  detail::key_window window;
+  std::size_t lo = 0;
+  std::size_t hi = 0;
+  int key = 0;
+  costs prev{};
+  std::array<std::int8_t, detail::spelling_candidates> prev_fifths{};
+
+  for (std::size_t i = 0; i < count; ++i) {
+    for (; hi < count && hi <= i + options.window; ++hi)
+      window.add(notes[hi].get_pitch());
+    for (; lo + options.window < i; ++lo)
+      window.remove(notes[lo].get_pitch());
+    key = window.best(key);
+
+    const auto &fifths = detail::pitch_class_spellings[static_cast<std::size_t>(notes[i].get_pitch())];
+    costs cur{};
+    std::uint8_t back = 0;
+    for (std::size_t c = 0; c < detail::spelling_candidates; ++c) {
+      int fifth = fifths[c];
+      int outside = std::max({0, key - 1 - fifth, fifth - key - 5});
+      int cost = options.accidental_cost * detail::accidental_count(fifth) +
+                 options.key_cost * outside;
+      if (i > 0) {
+        int best = 0;
+        std::size_t best_p = 0;
+        for (std::size_t p = 0; p < detail::spelling_candidates; ++p) {
+          int leap = fifth - prev_fifths[p];
+          leap = leap < 0 ? -leap : leap;
+          int total = prev[p] + options.leap_cost * std::max(0, leap - 6);
+          if (p == 0 || total < best) {
+            best = total;
+            best_p = p;
+          }
+        }
+        cost += best;
+        back = static_cast<std::uint8_t>(back | best_p << (2 * c));
+      }
+      cur[c] = cost;
+    }
+    from[i] = back;
+    prev = cur;
+    prev_fifths = fifths;
+  }
+
+  auto choice = static_cast<std::size_t>(std::ranges::min_element(prev) - prev.begin());
+  for (std::size_t i = count; i-- > 0;) {
+    const auto &fifths = detail::pitch_class_spellings[static_cast<std::size_t>(notes[i].get_pitch())];
+    auto next = static_cast<std::size_t>(from[i] >> (2 * choice) & 3u);
+    notes[i] = detail::respell(notes[i], fifths[choice]);
+    choice = next;
+  }
+}
+
+template <std::size_t N>
+[[nodiscard]] constexpr melody<N> spell(const melody<N> &m,
+                                        const spelling_options &options = {}) {
+  std::array<note, N> pitches{};
+  std::size_t count = 0;
+  for (const auto &ev : m.events) {
+    if (!ev.is_rest)
+      pitches[count++] = ev.pitch;
+  }
+  spell_notes(std::span<note>(pitches.data(), count), options);
+  melody<N> result = m;
+  count = 0;
+  for (auto &ev : result.events) {
+    if (!ev.is_rest)
+      ev.pitch = pitches[count++];
+  }
+  return result;
+}
+
+}
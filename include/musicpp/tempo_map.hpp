@@ -0,0 +1,188 @@
+#pragma once
+#include "duration.hpp"
+#include "timing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace musicpp {
+
+namespace detail {
+[[nodiscard]] constexpr double whole_notes(wide_duration d) noexcept {
+  return static_cast<double>(d.num) / static_cast<double>(d.den);
+}
+
+[[nodiscard]] constexpr double whole_notes(ticks t, timebase tb) noexcept {
+  return static_cast<double>(t.count) / static_cast<double>(tb.whole_ticks());
+}
+}
+
+// Tempo as a function of score position. Each segment starts at a position
+// (in whole notes) and either holds its rate or changes it linearly until
+// the next segment; rates are whole notes per second, so a ramp between two
+// tempi with the same beat unit is linear in BPM. Seconds elapsed at each
+// segment start are stored, which makes every lookup a binary search plus
+// a closed-form integral over one segment.
+class tempo_map {
+public:
+  explicit tempo_map(tempo initial = {}) {
+    m_segments.push_back({0.0, rate_of(initial), 0.0, 0.0});
+  }
+
+  tempo_map &set_tempo(wide_duration at, tempo t) {
+    append(detail::whole_notes(at), rate_of(t), 0.0);
+    return *this;
+  }
+
+  // Changes tempo linearly from whatever is in effect at `from` to `target`
+  // at `to`, then holds `target`.
+  tempo_map &ramp(wide_duration from, wide_duration to, tempo target) {
+    const double start = detail::whole_notes(from);
+    const double end = detail::whole_notes(to);
+    if (!(end > start))
+      throw std::invalid_argument("tempo ramp must end after it starts");
+    const double r0 = m_segments.back().rate;
+    const double r1 = rate_of(target);
+    append(start, r0, (r1 - r0) / (end - start));
+    append(end, r1, 0.0);
+    return *this;
+  }
+
+  [[nodiscard]] double seconds(wide_duration at) const noexcept {
+    return seconds_at(detail::whole_notes(at));
+  }
+
+  [[nodiscard]] double seconds(ticks at, timebase tb) const noexcept {
+    return seconds_at(detail::whole_notes(at, tb));
+  }
+
+  // Score position, in whole notes, sounding at the given time.
+  [[nodiscard]] double position(double seconds) const noexcept {
+    const auto &seg = m_segments[find_seconds(seconds)];
+    return seg.position + advance(seg, seconds - seg.seconds);
+  }
+
+  [[nodiscard]] ticks tick_at(double seconds, timebase tb) const noexcept {
+    return ticks{std::llround(position(seconds) *
+                              static_cast<double>(tb.whole_ticks()))};
+  }
+
+  [[nodiscard]] tempo tempo_at(wide_duration at,
+                               duration beat = durations::quarter) const noexcept {
+    const double x = detail::whole_notes(at);
+    const auto &seg = m_segments[find_position(x)];
+    const double rate = seg.rate + seg.slope * (x - seg.position);
+    return {rate * 60.0 * beat.den / beat.num, beat};
+  }
+
+  // Batch conversions walk the segments alongside the input, so sorted
+  // input costs one linear merge; out-of-order elements fall back to a
+  // binary search.
+  std::span<double> seconds(std::span<const wide_duration> onsets,
+                            std::span<double> out) const noexcept {
+    return merge(onsets, out, [](wide_duration d) { return detail::whole_notes(d); },
+                 &segment::position, [this](const segment &seg, double x) {
+                   return seg.seconds + elapsed(seg, x - seg.position);
+                 });
+  }
+
+  std::span<double> seconds(std::span<const ticks> onsets, timebase tb,
+                            std::span<double> out) const noexcept {
+    return merge(onsets, out, [tb](ticks t) { return detail::whole_notes(t, tb); },
+                 &segment::position, [this](const segment &seg, double x) {
+                   return seg.seconds + elapsed(seg, x - seg.position);
+                 });
+  }
+
+  std::span<double> positions(std::span<const double> times,
+                              std::span<double> out) const noexcept {
+    return merge(times, out, [](double t) { return t; }, &segment::seconds,
+                 [this](const segment &seg, double t) {
+                   return seg.position + advance(seg, t - seg.seconds);
+                 });
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_segments.size(); }
+
+private:
+  struct segment {
+    double position;
+    double rate;
+    double slope;
+    double seconds;
+  };
+
+  [[nodiscard]] static double rate_of(tempo t) {
+    if (!(t.bpm > 0.0) || !std::isfinite(t.bpm) || t.beat.num <= 0)
+      throw std::invalid_argument("tempo must be positive");
+    return t.bpm / 60.0 * t.beat.num / t.beat.den;
+  }
+
+  [[nodiscard]] static double elapsed(const segment &seg, double dx) noexcept {
+    if (seg.slope == 0.0)
+      return dx / seg.rate;
+    return std::log1p(seg.slope * dx / seg.rate) / seg.slope;
+  }
+
+  [[nodiscard]] static double advance(const segment &seg, double dt) noexcept {
+    if (seg.slope == 0.0)
+      return seg.rate * dt;
+    return seg.rate * std::expm1(seg.slope * dt) / seg.slope;
+  }
+
+  void append(double position, double rate, double slope) {
+    auto &last = m_segments.back();
+    if (!std::isfinite(position) || position < last.position)
+      throw std::invalid_argument("tempo changes must be added in order");
+    if (position == last.position) {
+      last.rate = rate;
+      last.slope = slope;
+      return;
+    }
+    const double start = last.seconds + elapsed(last, position - last.position);
+    m_segments.push_back({position, rate, slope, start});
+  }
+
+  [[nodiscard]] double seconds_at(double x) const noexcept {
+    const auto &seg = m_segments[find_position(x)];
+    return seg.seconds + elapsed(seg, x - seg.position);
+  }
+
+  [[nodiscard]] std::size_t find(double key, double segment::*field) const noexcept {
+    auto it = std::upper_bound(
+        m_segments.begin() + 1, m_segments.end(), key,
+        [field](double k, const segment &seg) { return k < seg.*field; });
+    return static_cast<std::size_t>(it - m_segments.begin()) - 1;
+  }
+
+  [[nodiscard]] std::size_t find_position(double x) const noexcept {
+    return find(x, &segment::position);
+  }
+
+  [[nodiscard]] std::size_t find_seconds(double t) const noexcept {
+    return find(t, &segment::seconds);
+  }
+
+  template <typename In, typename Key, typename Eval>
+  std::span<double> merge(std::span<const In> in, std::span<double> out, Key key,
+                          double segment::*field, Eval eval) const noexcept {
+    const auto count = std::min(in.size(), out.size());
+    std::size_t s = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      const double k = key(in[i]);
+      if (k < m_segments[s].*field)
+        s = find(k, field);
+      while (s + 1 < m_segments.size() && m_segments[s + 1].*field <= k)
+        ++s;
+      out[i] = eval(m_segments[s], k);
+    }
+    return out.first(count);
+  }
+
+  std::vector<segment> m_segments;
+};
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace musicpp::detail {
+
+template <typename Out>
+constexpr Out write_chars(Out out, std::string_view s) {
+  for (char c : s)
+    *out++ = c;
+  return out;
+}
+
+template <typename Out> constexpr Out write_repeat(Out out, char c, int n) {
+  for (int i = 0; i < n; ++i)
+    *out++ = c;
+  return out;
+}
+
+template <typename Out> constexpr Out write_int(Out out, std::int64_t value) {
+  std::uint64_t magnitude = value < 0 ? 0u - static_cast<std::uint64_t>(value)
+                                      : static_cast<std::uint64_t>(value);
+  if (value < 0)
+    *out++ = '-';
+  std::array<char, 20> digits{};
+  std::size_t n = 0;
+  do {
+    digits[n++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude);
+  while (n > 0)
+    *out++ = digits[--n];
+  return out;
+}
+
+template <typename Out, typename Range>
+constexpr Out write_joined(Out out, const Range &items, std::string_view sep) {
+  bool first = true;
+  for (const auto &item : items) {
+    if (!first)
+      out = write_chars(out, sep);
+    first = false;
+    out = item.write_to(out);
+  }
+  return out;
+}
+
+template <typename T>
+constexpr std::from_chars_result parse_int(const char *first, const char *last,
+                                           T &value) noexcept {
+  bool negative = first != last && *first == '-';
+  auto p = first + (negative ? 1 : 0);
+  if (p == last || *p < '0' || *p > '9')
+    return {first, std::errc::invalid_argument};
+  long long magnitude = 0;
+  for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+    magnitude = magnitude * 10 + (*p - '0');
+    if (magnitude > 1000000)
+      return {p, std::errc::result_out_of_range};
+  }
+  value = static_cast<T>(negative ? -magnitude : magnitude);
+  return {p, std::errc{}};
+}
+
+[[nodiscard]] constexpr bool fits_int8(int value) noexcept {
+  return value >= INT8_MIN && value <= INT8_MAX;
+}
+
+class bounded_writer {
+public:
+  constexpr bounded_writer(char *first, char *last) noexcept
+      : m_pos(first), m_end(last) {}
+
+  constexpr bounded_writer &operator=(char c) noexcept {
+    if (m_pos != m_end)
+      *m_pos++ = c;
+    ++m_count;
+    return *this;
+  }
+  constexpr bounded_writer &operator*() noexcept { return *this; }
+  constexpr bounded_writer &operator++() noexcept { return *this; }
+  constexpr bounded_writer &operator++(int) noexcept { return *this; }
+
+  [[nodiscard]] constexpr std::size_t count() const noexcept { return m_count; }
+
+private:
+  char *m_pos;
+  char *m_end;
+  std::size_t m_count{0};
+};
+
+template <typename T, std::size_t Capacity = 256>
+[[nodiscard]] constexpr std::string to_text(const T &value) {
+  std::array<char, Capacity> buffer{};
+  auto w = value.write_to(bounded_writer{buffer.data(), buffer.data() + Capacity});
+  if (w.count() <= Capacity)
+    return std::string(buffer.data(), w.count());
+  std::string result(w.count(), '\0');
+  value.write_to(result.data());
+  return result;
+}
+
+template <typename T, std::size_t Capacity = 256>
+struct text_formatter : std::formatter<std::string_view> {
+  auto format(const T &value, auto &ctx) const {
+    std::array<char, Capacity> buffer;
+    auto w = value.write_to(bounded_writer{buffer.data(), buffer.data() + Capacity});
+    if (w.count() <= Capacity)
+      return std::formatter<std::string_view>::format(
+          std::string_view{buffer.data(), w.count()}, ctx);
+    return std::formatter<std::string_view>::format(to_text(value), ctx);
+  }
+};
+
+}
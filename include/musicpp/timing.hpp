@@ -64,12 +64,39 @@ struct time_signature {
     return total / per_bar;
   }
 
+  [[nodiscard]] constexpr std::int64_t bar_count(wide_duration d) const noexcept {
+    auto bar = bar_duration();
+    if (bar.num == 0)
+      return 0;
+    return d.count_of(bar);
+  }
+
   [[nodiscard]] constexpr duration remainder(duration d) const noexcept {
     auto bar = bar_duration();
     int whole_bars = bar_count(d);
     return d + duration{-(bar.num * whole_bars), static_cast<int>(bar.den)};
   }
 
+  [[nodiscard]] constexpr wide_duration remainder(wide_duration d) const {
+    return (d - wide_duration{bar_duration()} * bar_count(d)).reduced();
+  }
+
+  [[nodiscard]] constexpr ticks beat_ticks(timebase tb) const {
+    return tb.to_ticks(beat_duration());
+  }
+
+  [[nodiscard]] constexpr ticks bar_ticks(timebase tb) const {
+    return tb.to_ticks(bar_duration());
+  }
+
+  [[nodiscard]] constexpr std::int64_t bar_count(ticks t, timebase tb) const {
+    return t.count / bar_ticks(tb).count;
+  }
+
+  [[nodiscard]] constexpr ticks remainder(ticks t, timebase tb) const {
+    return ticks{t.count % bar_ticks(tb).count};
+  }
+
 
   [[nodiscard]] constexpr std::string str() const {
     return std::to_string(beats) + "/" + std::to_string(beat_unit);
@@ -113,6 +140,11 @@ struct tempo {
     return beat_count * 60.0 / bpm;
   }
 
+  [[nodiscard]] constexpr double seconds(ticks t, timebase tb) const noexcept {
+    double quarters = static_cast<double>(t.count) / tb.ppq;
+    return quarters * beat.den / (4.0 * beat.num) * 60.0 / bpm;
+  }
+
   [[nodiscard]] constexpr double ms(duration d) const noexcept {
     return seconds(d) * 1000.0;
   }
@@ -168,11 +200,31 @@ struct metric_position {
     return (offset.num * bd.den) / (offset.den * bd.num);
   }
 
+  // Whole notes from the start of bar 0.
+  [[nodiscard]] constexpr wide_duration elapsed(time_signature ts) const {
+    return wide_duration{ts.bar_duration()} * bar + offset;
+  }
+
+  [[nodiscard]] constexpr metric_position advanced(wide_duration d,
+                                                   time_signature ts) const {
+    wide_duration bar_len{ts.bar_duration()};
+    auto at = wide_duration{offset} + d;
+    auto bars = at.count_of(bar_len);
+    return {bar + static_cast<int>(bars), (at - bar_len * bars).narrow()};
+  }
+
+  [[nodiscard]] constexpr metric_position rewound(wide_duration d,
+                                                  time_signature ts) const {
+    return advanced(wide_duration{-d.num, d.den}, ts);
+  }
+
   [[nodiscard]] std::string str() const {
     return std::to_string(bar + 1) + ":" +
            std::to_string(offset.beats() + 1.0);
   }
 
+  constexpr bool operator==(const metric_position &) const noexcept = default;
+
   friend std::ostream &operator<<(std::ostream &os,
                                   const metric_position &mp) {
     return os << mp.str();
@@ -180,17 +232,61 @@ struct metric_position {
 };
 
 
+[[nodiscard]] constexpr metric_position position_at(wide_duration at,
+                                                   time_signature ts) {
+  return metric_position{}.advanced(at, ts);
+}
+
+[[nodiscard]] constexpr wide_duration distance(const metric_position &from,
+                                               const metric_position &to,
+                                               time_signature ts) {
+  return (to.elapsed(ts) - from.elapsed(ts)).reduced();
+}
+
+
+struct tick_position {
+  int bar{0};
+  ticks offset{};
+
+  [[nodiscard]] constexpr bool is_downbeat() const noexcept {
+    return offset.count == 0;
+  }
+
+  [[nodiscard]] constexpr bool is_on_beat(time_signature ts, timebase tb) const {
+    return offset.count % ts.beat_ticks(tb).count == 0;
+  }
+
+  [[nodiscard]] constexpr int beat_index(time_signature ts, timebase tb) const {
+    return static_cast<int>(offset.count / ts.beat_ticks(tb).count);
+  }
+
+  [[nodiscard]] constexpr metric_position metric(timebase tb) const {
+    return {bar, tb.to_duration(offset)};
+  }
+
+  [[nodiscard]] std::string str(timebase tb) const {
+    return std::to_string(bar + 1) + ":" +
+           std::to_string(static_cast<double>(offset.count) / tb.ppq + 1.0);
+  }
+
+  constexpr bool operator==(const tick_position &) const noexcept = default;
+};
+
+
 namespace detail {
-inline constexpr void advance_position(metric_position &pos, duration d,
-                                       time_signature ts) noexcept {
-  pos.offset = pos.offset + d;
-  auto bar_dur = ts.bar_duration();
-  while (pos.offset >= bar_dur) {
-    pos.offset =
-        pos.offset + duration{-bar_dur.num, static_cast<int>(bar_dur.den)};
-    ++pos.bar;
+inline constexpr void advance_position(tick_position &pos, ticks d,
+                                       ticks bar) noexcept {
+  pos.offset += d;
+  if (pos.offset >= bar) {
+    pos.bar += static_cast<int>(pos.offset.count / bar.count);
+    pos.offset.count %= bar.count;
   }
 }
+
+inline constexpr void advance_position(metric_position &pos, duration d,
+                                       time_signature ts) {
+  pos = pos.advanced(d, ts);
+}
 }
 
 
@@ -205,6 +301,18 @@ constexpr void melody<N>::walk(time_signature ts, F &&f) const {
 }
 
 
+template <std::size_t N>
+template <typename F>
+constexpr void melody<N>::walk(time_signature ts, timebase tb, F &&f) const {
+  tick_position pos;
+  auto bar = ts.bar_ticks(tb);
+  for (const auto &ev : *this) {
+    f(ev, pos);
+    detail::advance_position(pos, tb.to_ticks(ev.dur), bar);
+  }
+}
+
+
 template <typename... Events>
 template <typename F>
 constexpr void chord_sequence<Events...>::walk(time_signature ts, F &&f) const {
@@ -215,6 +323,18 @@ constexpr void chord_sequence<Events...>::walk(time_signature ts, F &&f) const {
   });
 }
 
+template <typename... Events>
+template <typename F>
+constexpr void chord_sequence<Events...>::walk(time_signature ts, timebase tb,
+                                               F &&f) const {
+  tick_position pos;
+  auto bar = ts.bar_ticks(tb);
+  for_each([&](const auto &ev) {
+    f(ev, pos);
+    detail::advance_position(pos, tb.to_ticks(ev.dur), bar);
+  });
+}
+
 }
 
 
@@ -0,0 +1,121 @@
+#pragma once
+#include "intervals.hpp"
+#include "notes.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+namespace musicpp {
+
+namespace detail {
+inline constexpr auto octave_scale = [] {
+  std::array<double, 256> table{};
+  for (int i = 0; i < 256; ++i) {
+    int octave = static_cast<std::int8_t>(i);
+    double scale = 1.0;
+    for (int k = 0; k < octave; ++k)
+      scale *= 2.0;
+    for (int k = 0; k > octave; --k)
+      scale /= 2.0;
+    table[static_cast<std::size_t>(i)] = scale;
+  }
+  return table;
+}();
+
+// Number of syntonic commas a 5-limit pitch sits below its Pythagorean
+// spelling: F, C, G and D are pure fifths from the tonic, A through C#
+// are reached by major thirds, and so on outward along the line of fifths.
+[[nodiscard]] constexpr int syntonic_commas(int fifths_from_tonic) noexcept {
+  int shifted = fifths_from_tonic + 1;
+  return shifted >= 0 ? shifted / 4 : (shifted - 3) / 4;
+}
+}
+
+struct pitch_reference {
+  note pitch{notes::A(4)};
+  double frequency{440.0};
+};
+
+class tuning {
+public:
+  [[nodiscard]] static tuning equal_temperament(pitch_reference ref = {}) {
+    return regular(700.0, ref);
+  }
+
+  [[nodiscard]] static tuning pythagorean(pitch_reference ref = {}) {
+    return regular(1200.0 * std::log2(1.5), ref);
+  }
+
+  [[nodiscard]] static tuning quarter_comma_meantone(pitch_reference ref = {}) {
+    return regular(300.0 * std::log2(5.0), ref);
+  }
+
+  [[nodiscard]] static tuning regular(double fifth_cents, pitch_reference ref = {}) {
+    if (!std::isfinite(fifth_cents))
+      throw std::invalid_argument("fifth size must be finite");
+    return tuning(fifth_cents, ref, [](int) { return 0.0; });
+  }
+
+  [[nodiscard]] static tuning just_intonation(note tonic = notes::C,
+                                              pitch_reference ref = {}) {
+    const double comma = std::log2(81.0 / 80.0);
+    return tuning(1200.0 * std::log2(1.5), ref, [=](int fifth) {
+      return -comma * detail::syntonic_commas(fifth - tonic.get_fifth());
+    });
+  }
+
+  [[nodiscard]] double fifth_cents() const noexcept { return m_fifth_cents; }
+
+  [[nodiscard]] double frequency(const note &n) const noexcept {
+    return m_fifths[static_cast<std::uint8_t>(n.get_fifth())] *
+           detail::octave_scale[static_cast<std::uint8_t>(n.get_octave())];
+  }
+
+  [[nodiscard]] double cents(const note &from, const note &to) const noexcept {
+    return 1200.0 * std::log2(frequency(to) / frequency(from));
+  }
+
+  std::span<double> frequencies(std::span<const note> in,
+                                std::span<double> out) const noexcept {
+    return convert(in, out);
+  }
+
+  std::span<float> frequencies(std::span<const note> in,
+                               std::span<float> out) const noexcept {
+    return convert(in, out);
+  }
+
+private:
+  template <typename Correction>
+  tuning(double fifth_cents, pitch_reference ref, Correction correction)
+      : m_fifth_cents(fifth_cents) {
+    if (!(ref.frequency > 0.0) || !std::isfinite(ref.frequency))
+      throw std::invalid_argument("reference frequency must be positive");
+    const double fifth = fifth_cents / 1200.0;
+    auto log2_of = [&](int f) { return f * fifth + correction(f); };
+    const int ref_fifth = ref.pitch.get_fifth();
+    const double ref_log2 = log2_of(ref_fifth) + ref.pitch.get_octave();
+    for (int i = 0; i < 256; ++i) {
+      int f = static_cast<std::int8_t>(i);
+      m_fifths[static_cast<std::size_t>(i)] =
+          ref.frequency * std::exp2(log2_of(f) - ref_log2);
+    }
+  }
+
+  template <typename T>
+  std::span<T> convert(std::span<const note> in, std::span<T> out) const noexcept {
+    const auto count = std::min(in.size(), out.size());
+    for (std::size_t i = 0; i < count; ++i)
+      out[i] = static_cast<T>(frequency(in[i]));
+    return out.first(count);
+  }
+
+  std::array<double, 256> m_fifths{};
+  double m_fifth_cents;
+};
+
+}
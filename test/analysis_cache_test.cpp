@@ -0,0 +1,125 @@
+#include <boost/ut.hpp>
+#include <musicpp/analysis_cache.hpp>
+#include <thread>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::intervals;
+    using namespace musicpp::chord_patterns;
+    using namespace musicpp::scale_patterns;
+    using namespace std::literals;
+
+    "cached result matches direct analysis"_test = [] {
+        key_analysis_cache cache;
+        auto key = C(4) + major;
+        for (auto chord : {C(4) + maj7, D(4) + min7, G(3) + dom7, B(3) + half_dim7,
+                           Ab(3) + maj7, C(4) + maj7.inversion<2>()}) {
+            expect(cache.analyze(chord, key).str() == chord.analyze(key).str());
+        }
+        expect(cache.misses() == 6_ul);
+        expect(cache.hits() == 0_ul);
+        expect(cache.size() == 6_ul);
+    };
+
+    "repeated lookups hit"_test = [] {
+        key_analysis_cache cache;
+        auto key = G(4) + major;
+        const auto &first = cache.analyze(D(4) + dom7, key);
+        const auto &second = cache.analyze(D(3) + dom7, key);
+        const auto &third = cache.analyze(D(4) + dom7, key);
+        expect(&first == &third);
+        expect(&first != &second);
+        expect(first.str() == "V7"s);
+        expect(second == (D(3) + dom7).analyze(key));
+        expect(cache.misses() == 2_ul);
+        expect(cache.hits() == 1_ul);
+        expect(cache.size() == 2_ul);
+    };
+
+    "entries keep each voicing's root and bass"_test = [] {
+        key_analysis_cache cache;
+        auto key = C(4) + major;
+        std::vector<chord_instance<4>> chords{
+            C(2) + maj7, C(4) + maj7, C(6) + maj7,
+            C(2) + maj7.inversion<1>(), C(5) + maj7.inversion<1>(),
+            C(3) + maj7.inversion<3>(), Db(3) + dom7, Cs(3) + dom7,
+            G(1) + dom7.inversion<2>(), G(4) + dom7.inversion<2>()};
+        for (int pass = 0; pass < 2; ++pass) {
+            for (const auto &chord : chords)
+                expect(cache.analyze(chord, key) == chord.analyze(key));
+        }
+        expect(cache.analyze(C(2) + maj7, key)[0].chord.root.get_midi_pitch() == 36_i);
+        auto bass = cache.analyze(C(2) + maj7.inversion<1>(), key)[0].chord.bass;
+        expect(bass.has_value() && bass->get_midi_pitch() == 40_i);
+        expect(cache.size() == 10_ul);
+        expect(cache.hits() == 12_ul);
+    };
+
+    "a different spelling of the same voicing shares the root"_test = [] {
+        key_analysis_cache cache;
+        auto key = C(4) + major;
+        chord_instance<4> spelled{{C(4), E(4), G(4), B(4)}};
+        chord_instance<4> respelled{{C(4), note(-8, 9), G(4), B(4)}};  // Fb4
+        const auto &a = cache.analyze(spelled, key);
+        const auto &b = cache.analyze(respelled, key);
+        expect(&a == &b);
+        expect(b == respelled.analyze(key));
+    };
+
+    "key and bass are part of the cache key"_test = [] {
+        key_analysis_cache cache;
+        auto c_major = C(4) + major;
+        auto f_major = F(4) + major;
+        auto chord = G(3) + major_triad;
+        expect(cache.analyze(chord, c_major)[0].str() == "V"s);
+        expect(cache.analyze(chord, f_major)[0].str() == "II"s);
+        auto inverted = G(3) + major_triad.inversion<1>();
+        expect(cache.analyze(inverted, c_major).str() == inverted.analyze(c_major).str());
+        expect(cache.misses() == 3_ul);
+    };
+
+    "cache keeps working when full"_test = [] {
+        key_analysis_cache cache(16, 1);
+        auto key = C(4) + major;
+        std::vector<chord_instance<3>> chords;
+        for (int f = -8; f < 12; ++f) {
+            auto root = note(static_cast<std::int8_t>(f),
+                             static_cast<std::int8_t>(4 - f * 7 / 12));
+            chords.push_back(root + major_triad);
+            chords.push_back(root + minor_triad);
+        }
+        for (int pass = 0; pass < 2; ++pass) {
+            for (const auto &c : chords)
+                expect(cache.analyze(c, key) == c.analyze(key));
+        }
+        expect(cache.size() == 40_ul);
+        expect(cache.misses() == 40_ul);
+        expect(cache.hits() == 40_ul);
+    };
+
+    "concurrent readers share entries"_test = [] {
+        key_analysis_cache cache;
+        auto key = C(4) + major;
+        std::vector<chord_instance<4>> chords = {C(4) + maj7, D(4) + min7,
+                                                 E(4) + min7, F(4) + maj7,
+                                                 G(3) + dom7, A(3) + min7};
+        std::vector<std::thread> threads;
+        std::vector<int> mismatches(8, 0);
+        for (std::size_t t = 0; t < mismatches.size(); ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 500; ++i) {
+                    const auto &c = chords[static_cast<std::size_t>(i) % chords.size()];
+                    if (cache.analyze(c, key)[0].str() != c.analyze(key)[0].str())
+                        ++mismatches[t];
+                }
+            });
+        }
+        for (auto &t : threads) t.join();
+        for (int m : mismatches) expect(m == 0_i);
+        expect(cache.size() == chords.size());
+        expect(cache.hits() + cache.misses() == 4000_ul);
+    };
+}
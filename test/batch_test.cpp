@@ -0,0 +1,57 @@
+#include <boost/ut.hpp>
+#include <musicpp/batch.hpp>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::intervals;
+    using namespace musicpp::chord_patterns;
+    using namespace std::literals;
+
+    "batch matches per-chord analysis"_test = [] {
+        std::vector<chord_instance<4>> chords = {
+            C(4) + maj7, D(4) + min7, G(3) + dom7, B(3) + half_dim7,
+            C(4) + maj7.inversion<1>(), F(3) + maj6, A(3) + min7,
+            E(4) + dim7};
+        auto results = analyze_batch(std::span<const chord_instance<4>>{chords});
+        expect(results.size() == chords.size());
+        for (std::size_t i = 0; i < chords.size(); ++i) {
+            expect(results[i].expand() == chords[i].analyze());
+        }
+    };
+
+    "batch spans several blocks"_test = [] {
+        std::vector<chord_instance<3>> chords;
+        for (int i = 0; i < 150; ++i) {
+            auto root = C(4) + interval(static_cast<std::int8_t>(i % 12 - 5), 0);
+            chords.push_back(root + (i % 2 ? minor_triad : major_triad));
+        }
+        std::vector<compact_analysis_result<>> out(chords.size());
+        analyze_batch(std::span<const chord_instance<3>>{chords}, std::span{out});
+        for (std::size_t i = 0; i < chords.size(); ++i) {
+            auto expected = chords[i].analyze_compact();
+            expect(out[i].size() == expected.size());
+            for (std::size_t k = 0; k < expected.size() && k < out[i].size(); ++k)
+                expect(out[i][k] == expected[k]);
+        }
+    };
+
+    "batch unrecognized chord"_test = [] {
+        std::vector<chord_instance<3>> chords = {
+            chord_instance<3>{{C(4), Cs(4), D(4)}}};
+        auto results = analyze_batch(std::span<const chord_instance<3>>{chords});
+        expect(results[0].empty());
+        expect(results[0].str() == "?"s);
+    };
+
+    "batch output shorter than input"_test = [] {
+        std::vector<chord_instance<3>> chords = {C(4) + major_triad,
+                                                 D(4) + minor_triad};
+        std::vector<compact_analysis_result<>> out(1);
+        analyze_batch(std::span<const chord_instance<3>>{chords}, std::span{out});
+        expect(!out[0].empty());
+        expect(out[0].expand() == chords[0].analyze());
+    };
+}
@@ -0,0 +1,112 @@
+#include <boost/ut.hpp>
+#include <musicpp/chord_dictionary.hpp>
+#include <thread>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::intervals;
+    using namespace musicpp::chord_patterns;
+    using namespace std::literals;
+
+    "default dictionary matches built-in analysis"_test = [] {
+        chord_dictionary dict;
+        expect(dict.size() == detail::chord_db.size());
+        expect(dict.max_interpretations() == detail::max_interpretations);
+        for (auto chord : {C(4) + maj7, D(4) + min7, G(3) + dom7, B(3) + half_dim7}) {
+            expect(chord.analyze(dict).str() == chord.analyze().str());
+            expect(chord.analyze_compact(dict).str() == chord.analyze().str());
+        }
+    };
+
+    "custom quality is recognized"_test = [] {
+        constexpr auto maj7_sharp11 = maj7.add(A11);
+        auto dict = chord_dictionary_builder{}.add("maj7#11", maj7_sharp11).build();
+        expect(dict.size() == detail::chord_db.size() + 1);
+        expect(dict.contains("maj7#11"));
+
+        auto chord = F(3) + maj7_sharp11;
+        expect(chord.analyze().str() != "Fmaj7#11"s);
+        auto result = chord.analyze(dict);
+        expect(!result.empty());
+        expect(result[0].str() == "Fmaj7#11"s);
+    };
+
+    "custom quality with omission"_test = [] {
+        constexpr auto m11_flat5 = half_dim7.add(M9).add(P11);
+        auto dict = chord_dictionary_builder{}.add("m11b5", m11_flat5).build();
+        auto chord = A(3) + m11_flat5.omit<4>();
+        bool found = false;
+        for (const auto &a : chord.analyze(dict)) {
+            if (a.str() == "Am11b5(no9)"s) found = true;
+        }
+        expect(found) << "should find Am11b5(no9)";
+    };
+
+    "quartal stack"_test = [] {
+        constexpr auto quartal = chord_pattern<3>{{P1, P4, m7}};
+        auto dict = chord_dictionary_builder{}.clear().add("q", quartal).build();
+        expect(dict.size() == 1_ul);
+        auto result = (D(4) + quartal).analyze_compact(dict);
+        expect(result.size() == 1_ul);
+        expect(result[0].name() == "Dq"sv);
+        expect((C(4) + major_triad).analyze(dict).empty());
+    };
+
+    "patterns without a root or with a taken name are rejected"_test = [] {
+        chord_dictionary_builder builder;
+        expect(throws<std::invalid_argument>(
+            [&] { builder.add("rootless", chord_pattern<3>{{M3, P5, m7}}); }));
+        expect(throws<std::invalid_argument>([&] { builder.add("maj7", maj7.add(A11)); }));
+        expect(throws<std::invalid_argument>(
+            [&] { builder.add("q", chord_pattern<3>{{P1, P4, m7}}).add("q", dom7); }));
+        expect(builder.size() == detail::chord_db.size() + 1);
+
+        auto dict = chord_dictionary_builder{}.clear().add("maj", major_triad).build();
+        expect((C(4) + major_triad).analyze(dict).str() == "Cmaj"s);
+    };
+
+    "compact analysis is sized from the dictionary"_test = [] {
+        chord_dictionary_builder builder;
+        for (std::size_t i = 0; i <= detail::max_interpretations; ++i)
+            builder.add("9/" + std::to_string(i), dom9);
+        auto dict = builder.build();
+        expect(dict.max_interpretations() > detail::max_interpretations);
+
+        auto chord = C(4) + dom9;
+        auto all = chord.analyze(dict);
+        auto compact = chord.analyze_compact(dict);
+        expect(compact.capacity() == dict.max_interpretations());
+        expect(compact.size() == all.size());
+        expect(compact.size() > detail::max_interpretations);
+        for (std::size_t i = 0; i < all.size(); ++i)
+            expect(compact[i].expand() == all[i]);
+
+        auto best = chord.analyze_compact<2>(dict);
+        expect(best.size() == 2_ul);
+        expect(best[0].expand() == all[0]);
+    };
+
+    "dictionary lookup by pitch class set"_test = [] {
+        auto dict = chord_dictionary_builder{}.add("7alt", dom7_sharp5_sharp9).build();
+        auto matches = dict.find(detail::chord_db[0].pitch_class_set);
+        expect(!matches.empty());
+        expect(dict.name(matches[0].chord) == detail::chord_db[0].name);
+    };
+
+    "dictionary is shared across threads"_test = [] {
+        auto dict = chord_dictionary_builder{}.add("maj7#11", maj7.add(A11)).build();
+        std::vector<std::string> names(4);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            threads.emplace_back([&, i] {
+                auto copy = dict;
+                names[i] = (C(4) + maj7.add(A11)).analyze(copy)[0].str();
+            });
+        }
+        for (auto &t : threads) t.join();
+        for (const auto &n : names) expect(n == "Cmaj7#11"s);
+    };
+}
@@ -0,0 +1,106 @@
+#include <boost/ut.hpp>
+#include <musicpp/chord_scoring.hpp>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::intervals;
+    using namespace musicpp::chord_patterns;
+    using namespace std::literals;
+
+    // Every (root, quality) score under the default weights, counted tone by
+    // tone, best first.
+    auto expected_scores = [](const auto &chord) {
+        std::array<bool, 12> present{};
+        for (const auto &n : chord.notes)
+            present[static_cast<std::size_t>(n.get_pitch())] = true;
+        std::vector<int> scores;
+        for (std::size_t root = 0; root < 12; ++root) {
+            for (const auto &info : detail::chord_db) {
+                int common = 0, added = 0, missing = 0;
+                for (std::size_t pc = 0; pc < 12; ++pc) {
+                    bool sounding = present[(root + pc) % 12];
+                    bool in_quality = (info.pitch_class_set >> pc) & 1u;
+                    common += sounding && in_quality;
+                    added += sounding && !in_quality;
+                    missing += !sounding && in_quality;
+                }
+                if (common > 0)
+                    scores.push_back(2 * added + 3 * missing + (present[root] ? 0 : 4));
+            }
+        }
+        std::sort(scores.begin(), scores.end());
+        return scores;
+    };
+
+    "exact match scores zero"_test = [] {
+        auto result = analyze_scored(D(4) + min7);
+        expect(!result.empty());
+        expect(result[0].exact());
+        expect(result[0].score == 0_i);
+        expect(result[0].str() == (D(4) + min7).analyze()[0].str());
+    };
+
+    "passing tone is tolerated"_test = [] {
+        chord_instance<4> chord{{C(4), E(4), F(4), G(4)}};
+        expect(chord.analyze().str() != "C"s);
+        auto result = analyze_scored<3>(chord);
+        expect(result.size() == 3_u);
+        expect(result[0].str() == "Cadd11"s || result[0].exact());
+        auto weights = match_weights{.added = 1, .missing = 3, .missing_root = 4};
+        auto loose = analyze_scored<8>(chord, weights);
+        bool has_c = false;
+        for (const auto &a : loose)
+            has_c = has_c || (a.str() == "C"s && a.added == (1u << 5));
+        expect(has_c);
+    };
+
+    "rootless voicing"_test = [] {
+        chord_instance<4> chord{{E(3), G(3), B(3), D(4)}};
+        auto result = analyze_scored<40>(chord);
+        bool rootless_c = false;
+        for (const auto &a : result) {
+            if (a.root_missing() && a.analysis.root.get_pitch() == 0 &&
+                a.analysis.quality() == "maj9")
+                rootless_c = true;
+        }
+        expect(rootless_c);
+    };
+
+    "cluster gets best guesses"_test = [&] {
+        chord_instance<3> chord{{C(4), Cs(4), D(4)}};
+        expect(chord.analyze().empty());
+        auto result = analyze_scored(chord);
+        expect(result.size() == 5_u);
+        auto expected = expected_scores(chord);
+        for (std::size_t i = 0; i < result.size(); ++i)
+            expect(result[i].score == expected[i]);
+    };
+
+    "scores follow an independent ranking"_test = [&] {
+        auto chord = G(3) + dom9;
+        auto result = analyze_scored<12>(chord);
+        expect(result.size() == 12_u);
+        expect(result[0].exact());
+        auto expected = expected_scores(chord);
+        for (std::size_t i = 0; i < result.size(); ++i)
+            expect(result[i].score == expected[i]);
+    };
+
+    "scoring is constexpr"_test = [] {
+        constexpr auto result = analyze_scored<1>(C(4) + maj7);
+        static_assert(result[0].name() == "Cmaj7");
+    };
+
+    "scoring with dictionary"_test = [] {
+        constexpr auto maj7_sharp11 = maj7.add(A11);
+        auto dict = chord_dictionary_builder{}.add("maj7#11", maj7_sharp11).build();
+        auto result = analyze_scored(F(3) + maj7_sharp11, dict);
+        expect(result[0].exact());
+        expect(result[0].str() == "Fmaj7#11"s);
+    };
+}
@@ -189,4 +189,25 @@ int main() {
         auto d = seq.total_duration();
         expect(d == duration{3, 4});
     };
+
+
+    "event name"_test = [] {
+        static_assert(((D(4) + min7) * q).name() == "Dm7");
+        static_assert(chord_rest(q).name() == "-");
+        static_assert((chord_instance<3>{{C(4), Cs(4), D(4)}} * q).name() == "?");
+    };
+
+    "sequence names_ct"_test = [] {
+        constexpr auto seq = (C(4) + major_triad) * h
+                           | (A(3) + minor_triad) * h
+                           | chord_rest(q)
+                           | (G(3) + dom7) * h;
+        constexpr auto names = seq.names_ct();
+        static_assert(names.size() == 4);
+        static_assert(names[0] == "C");
+        static_assert(names[1] == "Am");
+        static_assert(names[2] == "-");
+        static_assert(names[3] == "G7");
+        expect(names[1].str() == "Am"s);
+    };
 }
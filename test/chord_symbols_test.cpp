@@ -0,0 +1,124 @@
+#include <boost/ut.hpp>
+#include <musicpp/chord_symbols.hpp>
+#include <array>
+#include <format>
+#include <string_view>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::intervals;
+    using namespace musicpp::chord_patterns;
+    using namespace musicpp::literals;
+    using namespace std::literals;
+
+    auto parse = [](std::string_view text) {
+        chord_symbol s;
+        auto [end, ec] = from_chars(text.data(), text.data() + text.size(), s);
+        expect(ec == std::errc{}) << text;
+        expect(end == text.data() + text.size()) << text;
+        return s;
+    };
+
+    "parse quality and root"_test = [&] {
+        auto s = parse("Bbmaj7/F");
+        expect(s.root == Bb(4));
+        expect(s.quality() == "maj7"sv);
+        expect(s.bass.has_value());
+        expect(s.bass->str() == "F4"s);
+        expect(s.chord<4>().notes == (Bb(4) + maj7).notes);
+        expect(s.str() == "Bbmaj7/F"s);
+
+        expect(parse("C").quality() == ""sv);
+        expect(parse("Cm").quality() == "m"sv);
+        expect(parse("C7#5b9").quality() == "7#5b9"sv);
+        expect(parse("C6/9").quality() == "6/9"sv);
+        expect(parse("Cm(maj7)").quality() == "m(maj7)"sv);
+        expect(parse("F#m7b5").root == Fs(4));
+    };
+
+    "parse tensions and omissions"_test = [&] {
+        auto gm = parse("Gm7(11)");
+        expect(gm.quality() == "m7"sv);
+        expect(gm.tension_count == 1_u);
+        expect(gm.tensions[0] == P11);
+        expect(gm.size() == 5_u);
+        expect(gm.str() == "Gm7(11)"s);
+
+        auto c = parse("C7(no3,b13)");
+        expect(c.size() == 4_u);
+        std::array<note, 4> out{};
+        expect(c.notes(out) == 4_u);
+        expect(out[0] == C(4) && out[1] == G(4) && out[2] == Bb(4));
+        expect(out[3] == Ab(5));
+        expect(c.str() == "C7(no3,b13)"s);
+
+        expect(parse("C7b13").str() == "C7(b13)"s);
+        expect(parse("Cadd9").quality() == "add9"sv);
+        expect(parse("Cmaj7add13").tensions[0] == M13);
+    };
+
+    "slash chord places bass below root"_test = [&] {
+        auto s = parse("F/A");
+        expect(s.bass->get_midi_pitch() == 57_i);
+        auto sc = s.slash_chord<3>(3);
+        expect(sc.bass == A(2));
+        expect(sc.chord.notes == (F(3) + major_triad).notes);
+        expect(parse("C/C").bass == C(3));
+    };
+
+    "names round trip through the parser"_test = [&] {
+        for (const auto &info : detail::chord_db) {
+            auto name = "Eb"s + std::string(info.name);
+            expect(parse(name).str() == name) << name;
+        }
+        auto analysis = (D(4) + min7).analyze();
+        expect(parse(analysis[0].str()).chord<4>().notes == (D(4) + min7).notes);
+    };
+
+    "invalid symbols are rejected"_test = [] {
+        for (auto text : {"H7"sv, ""sv, "C7(no13)"sv, "C7(b9"sv, "C/x"sv,
+                          "C7(b9,b13,9,#11,13)"sv}) {
+            chord_symbol s;
+            auto [end, ec] = from_chars(text.data(), text.data() + text.size(), s);
+            expect(ec == std::errc::invalid_argument) << text;
+            expect(end == text.data()) << text;
+        }
+        chord_symbol s;
+        std::string_view partial = "Cmaj";
+        auto [end, ec] = from_chars(partial.data(), partial.data() + partial.size(), s);
+        expect(ec == std::errc{});
+        expect(std::string_view(end) == "aj"sv);
+    };
+
+    "batch parsing fills a span"_test = [] {
+        std::string_view chart = "| Dm7 G7 | Cmaj7, A7(b9) |\nDm7/A";
+        std::array<chord_symbol, 8> out{};
+        auto r = parse_chord_symbols(chart, out);
+        expect(r.ec == std::errc{});
+        expect(r.count == 5_u);
+        expect(r.ptr == chart.data() + chart.size());
+        expect(out[3].str() == "A7(b9)"s);
+        expect(out[4].bass->get_pitch() == 9_i);
+
+        std::array<chord_symbol, 2> small{};
+        auto first = parse_chord_symbols(chart, small);
+        expect(first.count == 2_u);
+        auto rest = parse_chord_symbols({first.ptr, chart.data() + chart.size()}, small);
+        expect(rest.count == 2_u);
+        expect(small[0].str() == "Cmaj7"s);
+
+        auto bad = parse_chord_symbols("C G7x F", out);
+        expect(bad.ec == std::errc::invalid_argument);
+        expect(bad.count == 1_u);
+        expect(std::string_view(bad.ptr) == "G7x F"sv);
+    };
+
+    "literals and formatting"_test = [] {
+        constexpr auto s = "Ebm9/Gb"_chord;
+        static_assert(s.quality() == "m9");
+        static_assert(s.size() == 5);
+        expect(std::format("{:>10}", s) == "   Ebm9/Gb"s);
+    };
+}
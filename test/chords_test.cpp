@@ -520,6 +520,28 @@ int main() {
         expect(!str.empty());
     };
 
+    "analysis write_to"_test = [] {
+        auto result = (D(4) + min7).analyze();
+        std::array<char, 256> buffer{};
+        auto end = result.write_to(buffer.data());
+        expect(std::string_view(buffer.data(), end) == result.str());
+        end = result[0].write_to(buffer.data());
+        expect(std::string_view(buffer.data(), end) == "Dm7"sv);
+        expect(std::format("{:<6}|", result[0]) == "Dm7   |"s);
+
+        auto compact = (D(4) + min7).analyze_compact();
+        end = compact.write_to(buffer.data());
+        expect(std::string_view(buffer.data(), end) == result.str());
+    };
+
+    "long analysis std::format"_test = [] {
+        analysis_result result;
+        for (int i = 0; i < 40; ++i)
+            result.interpretations.push_back((C(4) + maj7).analyze()[0]);
+        expect(std::format("{}", result) == result.str());
+        expect(result.str().size() == 40 * 5 + 39 * 3);
+    };
+
 
     "power chord"_test = [] {
         auto chord = C(4) + power_chord;
@@ -537,4 +559,93 @@ int main() {
         }
         expect(found) << "should find power chord (5)";
     };
+
+
+    "pitch class set lookup exact match"_test = [] {
+        auto matches = detail::find_matches(0b000010010001);
+        expect(matches.size() == 1_ul);
+        expect(detail::chord_db[matches[0].chord].name == ""sv);
+        expect(matches[0].omitted == 0_i);
+    };
+
+    "pitch class set lookup omission match"_test = [] {
+        auto matches = detail::find_matches(0b010000010001);
+        bool found = false;
+        for (const auto &m : matches) {
+            if (detail::chord_db[m.chord].name == "7"sv) {
+                found = true;
+                expect(m.omitted == (1 << 7));
+            }
+        }
+        expect(found) << "should find 7(no5)";
+    };
+
+    "pitch class set lookup without root"_test = [] {
+        expect(detail::find_matches(0b000010010000).empty());
+        expect(detail::find_matches(0).empty());
+    };
+
+    "compact analysis major triad"_test = [] {
+        auto result = (C(4) + major_triad).analyze_compact();
+        expect(!result.empty());
+        expect(result[0].quality() == ""sv);
+        expect(result[0].root.get_pitch() == C.get_pitch());
+        expect(!result[0].bass.has_value());
+        expect(result[0].omissions() == omission::none);
+        expect(result[0].str() == "C"s);
+    };
+
+    "compact analysis omissions"_test = [] {
+        auto chord = C(4) + dom7.omit<2>();
+        auto result = chord.analyze_compact();
+        expect(!result.empty());
+        expect(result[0].quality() == "7"sv);
+        expect(has(result[0].omissions(), omission::no5));
+        expect(!has(result[0].omissions(), omission::no3));
+        expect(result[0].omission_count() == 1_ul);
+        expect(result[0].str() == "C7(no5)"s);
+    };
+
+    "compact analysis inversion"_test = [] {
+        auto chord = C(4) + major_triad.inversion<1>();
+        auto result = chord.analyze_compact();
+        expect(!result.empty());
+        expect(result[0].bass.has_value());
+        expect(result[0].inversion == 1_i);
+        expect(result[0].str() == "C/E"s);
+    };
+
+    "compact analysis matches analyze"_test = [] {
+        auto chord = G(3) + dom13_no5;
+        expect(chord.analyze_compact().str() == chord.analyze().str());
+        expect(chord.analyze_compact().expand().size() == chord.analyze().size());
+    };
+
+    "compact analysis with root"_test = [] {
+        auto chord = A(3) + min7;
+        auto a = chord.analyze_compact(C(4));
+        expect(a.has_value());
+        expect(a->quality() == "6"sv);
+        expect(a->bass.has_value());
+        expect(!chord.analyze_compact(D(4)).has_value());
+    };
+
+    "compact analysis is constexpr"_test = [] {
+        constexpr auto result = (D(4) + min7).analyze_compact();
+        static_assert(result.size() >= 1);
+        static_assert(result[0].quality() == "m7");
+        static_assert(result[0].root.get_pitch() == 2);
+        static_assert(compact_analysis{}.quality().empty());
+        expect(compact_analysis{}.expand().omissions.empty());
+    };
+
+    "compile-time chord naming"_test = [] {
+        static_assert((C(4) + maj7).analyze_ct()[0].name() == "Cmaj7");
+        static_assert((Bb(3) + dom7.omit<2>()).analyze_ct()[0].name() == "Bb7(no5)");
+        static_assert((C(4) + major_triad.inversion<1>()).analyze_ct()[0].name() == "C/E");
+        constexpr auto name = (Fs(3) + half_dim7).analyze_ct()[0].name();
+        expect(name == "F#m7b5"sv);
+        expect(name.str() == "F#m7b5"s);
+        expect(std::format("{}", name) == "F#m7b5"s);
+    };
 }
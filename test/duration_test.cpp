@@ -1,5 +1,7 @@
 #include <boost/ut.hpp>
 #include <musicpp/duration.hpp>
+#include <format>
+#include <string_view>
 
 int main() {
     using namespace boost::ut;
@@ -127,4 +129,94 @@ int main() {
         duration d{5, 8};
         expect(d.str() == "5/8"s);
     };
+
+    "duration write_to"_test = [] {
+        char buffer[duration::max_chars];
+        auto end = duration{-7, 16}.write_to(buffer);
+        expect(std::string_view(buffer, end) == "-7/16"sv);
+        end = eighth.write_to(buffer);
+        expect(std::string_view(buffer, end) == "8th"sv);
+        expect(std::format("[{:>4}]", quarter) == "[   q]"s);
+    };
+
+    "tick conversion is exact"_test = [] {
+        constexpr timebase tb;
+        static_assert(tb.to_ticks(quarter) == ticks{960});
+        static_assert(tb.to_ticks(eighth.triplet()) == ticks{320});
+        static_assert(tb.to_ticks(quarter.dotted()) == ticks{1440});
+        static_assert(tb.to_duration(ticks{1440}) == quarter.dotted());
+        static_assert(tb.to_duration(ticks{0}) == duration{0, 1});
+        expect(tb.is_exact(duration{1, 64}));
+        expect(!tb.is_exact(duration{1, 7}));
+        expect(!timebase{96}.is_exact(duration{1, 256}));
+        expect(tb.to_ticks(duration{-3, 8}) == ticks{-1440});
+        expect(timebase{480}.to_duration(ticks{-720}) == duration{-3, 8});
+    };
+
+    "tick conversion rejects what it cannot represent"_test = [] {
+        expect(throws<const char *>([] { (void)timebase{0}; }));
+        expect(throws<const char *>([] { (void)timebase{-96}; }));
+        constexpr timebase tb;
+        expect(tb.to_duration(ticks{3840 * 8000}) == duration{8000, 1});
+        expect(throws<const char *>([&] { (void)tb.to_duration(ticks{3840 * 40000}); }));
+        expect(tb.to_duration(ticks{1}) == duration{1, 3840});
+        expect(throws<const char *>([] { (void)timebase{32749}.to_duration(ticks{1}); }));
+    };
+
+    "tick arithmetic"_test = [] {
+        ticks t{100};
+        t += ticks{20};
+        t -= ticks{5};
+        expect(t == ticks{115});
+        expect(t * 2 == ticks{230});
+        expect(ticks{3} - ticks{5} < ticks{0});
+    };
+
+    "wide duration accumulates without overflow"_test = [] {
+        wide_duration sum;
+        for (int bar = 0; bar < 2000; ++bar) {
+            for (int i = 0; i < 3; ++i) sum += eighth.triplet();
+            for (int i = 0; i < 5; ++i) sum += duration{1, 20};
+            for (int i = 0; i < 7; ++i) sum += duration{1, 28};
+            sum += quarter;
+        }
+        expect(sum == wide_duration{2000, 1});
+        expect(sum.reduced().num == 2000 && sum.reduced().den == 1);
+        expect(!sum.fits() || sum.narrow() == duration{2000, 1});
+        expect(sum.str() == "2000/1"s);
+
+        wide_duration big{100000, 3};
+        expect(!big.fits());
+        expect(big.str() == "100000/3"s);
+        expect(std::format("{}", big) == "100000/3"s);
+        expect(wide_duration{quarter} == quarter);
+    };
+
+    "wide duration comparison and division"_test = [] {
+        constexpr wide_duration a{7, 4};
+        static_assert(a > whole && a < duration{2, 1});
+        static_assert(a.count_of(half) == 3);
+        static_assert(wide_duration{-1, 4}.count_of(whole) == -1);
+        static_assert((a - quarter.dotted()).reduced() == wide_duration{11, 8});
+        static_assert((wide_duration{3, 8} + duration{1, 8}).narrow() == half);
+        expect(a.beats() == 7.0);
+    };
+
+    "wide duration comparison is exact near the denominator limit"_test = [] {
+        constexpr std::int64_t k = std::int64_t{1} << 20;
+        constexpr auto d1 = detail::max_wide_den - 1;
+        constexpr auto d2 = detail::max_wide_den - 3;
+        constexpr wide_duration a{k * d1 + 1, d1};
+        constexpr wide_duration b{k * d2 + 1, d2};
+        static_assert(a < b && b > a && a != b);
+        static_assert(a > wide_duration{k, 1} && b < wide_duration{k + 1, 1});
+        static_assert(wide_duration{-(k * d1 + 1), d1} > wide_duration{-(k * d2 + 1), d2});
+        static_assert(wide_duration{3 * k * d1, d1} == wide_duration{3 * k, 1});
+        static_assert(a.count_of(whole) == k);
+        static_assert(a.count_of(duration{3, 4}) == 1398101);
+        static_assert(b.count_of(wide_duration{1, d1}) == k * d1 + 1);
+        static_assert(wide_duration{-(k * d1 + 1), d1}.count_of(whole) == -k - 1);
+        static_assert(wide_duration{-k * d1, d1}.count_of(whole) == -k);
+        static_assert(wide_duration{k * d1, d1}.count_of(duration{-1, 2}) == -2 * k);
+    };
 }
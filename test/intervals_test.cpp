@@ -1,5 +1,9 @@
 #include <boost/ut.hpp>
 #include <musicpp/intervals.hpp>
+#include <format>
+#include <string>
+#include <string_view>
+#include <system_error>
 
 int main() {
     using namespace boost::ut;
@@ -126,4 +130,48 @@ int main() {
         expect(P1 != P5);
         expect(P1 < P5);
     };
+
+    "interval from_chars"_test = [] {
+        std::string_view text = "M9,P5";
+        interval iv;
+        auto [end, ec] = from_chars(text.data(), text.data() + text.size(), iv);
+        expect(ec == std::errc{});
+        expect(*end == ',');
+        expect(iv == M9);
+
+        for (auto s : {"P1", "m2", "A4", "d5", "M7", "P8", "A11", "m13", "dd7",
+                       "AA4", "d4", "-M3", "-P5"}) {
+            std::string_view sv = s;
+            auto r = from_chars(sv.data(), sv.data() + sv.size(), iv);
+            expect(r.ec == std::errc{});
+            expect(iv.str() == std::string(s));
+        }
+    };
+
+    "interval from_chars errors"_test = [] {
+        interval iv = P5;
+        for (std::string_view s : {"", "M5", "P3", "m4", "x3", "M0", "M-3", "M"}) {
+            auto r = from_chars(s.data(), s.data() + s.size(), iv);
+            expect(r.ec == std::errc::invalid_argument);
+            expect(r.ptr == s.data());
+        }
+        expect(iv == P5);
+    };
+
+    "interval literals"_test = [] {
+        using namespace musicpp::literals;
+        static_assert("M9"_iv == M9);
+        static_assert("m7"_iv == m7);
+        static_assert("-P4"_iv == -P4);
+        expect("A11"_iv == A11);
+    };
+
+    "interval write_to"_test = [] {
+        char buffer[interval::max_chars];
+        auto end = m7.write_to(buffer);
+        expect(std::string_view(buffer, end) == std::string_view("m7"));
+        end = (-M3).write_to(buffer);
+        expect(std::string_view(buffer, end) == std::string_view("-M3"));
+        expect(std::format("{:^5}", P5) == std::string(" P5  "));
+    };
 }
@@ -204,4 +204,16 @@ int main() {
         auto s = std::format("{}", m);
         expect(s == "C4(q) D4(q)"s);
     };
+
+    "long tuplet melody total"_test = [] {
+        melody<600> m{};
+        for (std::size_t i = 0; i < m.events.size(); i += 3) {
+            m.events[i] = C(4) * duration{1, 7};
+            m.events[i + 1] = D(4) * duration{1, 5};
+            m.events[i + 2] = E(4) * duration{1, 9};
+        }
+        auto total = m.total_duration();
+        expect(total == wide_duration{200 * (45 + 63 + 35), 315});
+        expect(total.str() == "5720/63"s);
+    };
 }
@@ -0,0 +1,90 @@
+#include <boost/ut.hpp>
+#include <musicpp/meter_map.hpp>
+#include <stdexcept>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::durations;
+    using namespace musicpp::chord_patterns;
+    using namespace musicpp::time_signatures;
+
+    "single meter matches time_signature"_test = [] {
+        meter_map meters{waltz};
+        expect(meters.size() == 1_u);
+        expect(meters.bar_start(4) == duration{3, 1});
+        auto pos = meters.position(duration{13, 8});
+        expect(pos.bar == 2_i);
+        expect(pos.offset == duration{1, 8});
+        expect(meters.meter_at_bar(100) == waltz);
+    };
+
+    "bar starts across meter changes"_test = [] {
+        meter_map meters;
+        meters.set_meter(2, seven_eight).set_meter(5, six_eight);
+        expect(meters.size() == 3_u);
+        expect(meters.bar_start(0) == duration{0, 1});
+        expect(meters.bar_start(2) == duration{2, 1});
+        expect(meters.bar_start(3) == duration{23, 8});
+        expect(meters.bar_start(5) == duration{37, 8});
+        expect(meters.bar_start(7) == duration{49, 8});
+        expect(meters.meter_at_bar(4) == seven_eight);
+        expect(meters.meter_at_bar(5) == six_eight);
+        expect(meters.meter_at(duration{37, 8}) == six_eight);
+        expect(meters.meter_at(duration{36, 8}) == seven_eight);
+    };
+
+    "positions invert bar starts"_test = [] {
+        meter_map meters{five_four};
+        meters.set_meter(3, common).set_meter(4, seven_eight).set_meter(10, cut);
+        for (int bar = 0; bar < 20; ++bar) {
+            auto start = meters.bar_start(bar);
+            auto pos = meters.position(start);
+            expect(pos.bar == bar && pos.is_downbeat());
+            auto later = meters.position(start + eighth);
+            expect(later.bar == bar && later.offset == eighth);
+        }
+        auto pos = meters.position(duration{31, 4});
+        expect(pos.bar == 7_i);
+        expect(pos.offset == duration{3, 8});
+    };
+
+    "melody walk follows the meter"_test = [] {
+        meter_map meters;
+        meters.set_meter(1, seven_eight).set_meter(2, six_eight);
+        auto m = C(4) * w | D(4) * q | E(4) * q | F(4) * q.dotted()
+               | G(4) * q.dotted() | A(4) * q.dotted() | B(4) * w;
+        std::vector<metric_position> positions;
+        m.walk(meters, [&](const auto &, auto pos) { positions.push_back(pos); });
+        expect(positions.size() == 7_u);
+        expect(positions[1].bar == 1_i && positions[1].is_downbeat());
+        expect(positions[3].bar == 1_i && positions[3].offset == half);
+        expect(positions[4].bar == 2_i && positions[4].is_downbeat());
+        expect(positions[5].bar == 2_i && positions[5].beat_index(six_eight) == 3_i);
+        expect(positions[6].bar == 3_i && positions[6].is_downbeat());
+    };
+
+    "chord walk matches a constant meter"_test = [] {
+        auto seq = (C(4) + major_triad) * h.dotted() | (G(3) + major_triad) * h
+                 | (F(3) + major_triad) * q | (C(4) + major_triad) * w;
+        std::vector<metric_position> plain;
+        seq.walk(waltz, [&](const auto &, auto pos) { plain.push_back(pos); });
+        std::vector<metric_position> mapped;
+        seq.walk(meter_map{waltz}, [&](const auto &, auto pos) { mapped.push_back(pos); });
+        expect(plain.size() == mapped.size());
+        for (std::size_t i = 0; i < plain.size(); ++i)
+            expect(plain[i].bar == mapped[i].bar && plain[i].offset == mapped[i].offset);
+    };
+
+    "invalid changes are rejected"_test = [] {
+        meter_map meters;
+        meters.set_meter(4, waltz);
+        expect(throws<std::invalid_argument>([&] { meters.set_meter(2, common); }));
+        expect(throws<std::invalid_argument>([&] { meters.set_meter(6, time_signature{0, 4}); }));
+        meters.set_meter(4, five_four);
+        expect(meters.size() == 2_u);
+        expect(meters.bar_start(5) == duration{21, 4});
+    };
+}
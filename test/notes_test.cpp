@@ -1,4 +1,5 @@
 #include <boost/ut.hpp>
+#include <array>
 #include <format>
 #include <sstream>
 #include <musicpp/notes.hpp>
@@ -136,6 +137,109 @@ int main() {
         expect(std::format("note: {}", A(4)) == "note: A4"s);
     };
 
+    "note std::format width"_test = [] {
+        expect(std::format("{:>5}|", Cs(4)) == "  C#4|"s);
+        expect(std::format("{:*<4}", Bb(3)) == "Bb3*"s);
+    };
+
+    "note write_to"_test = [] {
+        char buffer[note::max_chars];
+        auto end = Db(4).write_to(buffer);
+        expect(std::string_view(buffer, end) == "Db4"sv);
+        end = Fs(2).write_pitch_name(buffer);
+        expect(std::string_view(buffer, end) == "F#"sv);
+        end = note(19, 0).write_to(buffer);
+        expect(std::string_view(buffer, end) == note(19, 0).str());
+    };
+
+    "note from_chars"_test = [] {
+        std::string_view text = "Bb3 rest";
+        note n;
+        auto [end, ec] = from_chars(text.data(), text.data() + text.size(), n);
+        expect(ec == std::errc{});
+        expect(end == text.data() + 3);
+        expect(n == Bb(3));
+
+        for (auto s : {"C4"sv, "F#2"sv, "Ebb5"sv, "B#3"sv, "Cb-1"sv, "G##0"sv}) {
+            auto r = from_chars(s.data(), s.data() + s.size(), n);
+            expect(r.ec == std::errc{});
+            expect(n.str() == s);
+        }
+    };
+
+    "note from_chars errors"_test = [] {
+        note n = A(4);
+        for (auto s : {""sv, "H4"sv, "c4"sv, "C"sv, "C#"sv, "D-"sv}) {
+            auto r = from_chars(s.data(), s.data() + s.size(), n);
+            expect(r.ec == std::errc::invalid_argument);
+            expect(r.ptr == s.data());
+        }
+        std::string_view huge = "C99999999";
+        expect(from_chars(huge.data(), huge.data() + huge.size(), n).ec ==
+               std::errc::result_out_of_range);
+        expect(n == A(4));
+    };
+
+    "note literals"_test = [] {
+        using namespace musicpp::literals;
+        static_assert("Bb3"_n == Bb(3));
+        static_assert("C#4"_n == Cs(4));
+        static_assert("A0"_n.get_midi_pitch() == 21);
+        expect("Db4"_n == Db(4));
+    };
+
+    "note span kernels"_test = [] {
+        std::array<note, 4> in{C(4), Eb(4), Gs(2), B(7)};
+        std::array<note, 4> out{};
+        auto moved = transpose_notes(in, M2, out);
+        expect(moved.size() == 4_u);
+        expect(out[0] == D(4) && out[1] == F(4) && out[2] == As(2) && out[3] == Cs(8));
+
+        std::array<std::int8_t, 4> midi{};
+        expect(midi_pitches(in, midi).size() == 4_u);
+        expect(midi == std::array<std::int8_t, 4>{60, 63, 44, 107});
+
+        std::array<std::int8_t, 2> pcs{};
+        expect(pitch_classes(in, pcs).size() == 2_u);
+        expect(pcs == std::array<std::int8_t, 2>{0, 3});
+
+        transpose_notes(in, -m3);
+        expect(in[0] == A(3) && in[3] == Gs(7));
+
+        std::array<note, 3> spelled{note(9, -5), note(-8, 5), note(14, -8)};
+        simplify_notes(spelled, accidental_preference::flat);
+        expect(spelled[0] == Eb && spelled[1] == E && spelled[2] == D);
+    };
+
+    "note span kernels match scalar operations"_test = [] {
+        std::array<note, 256> all{};
+        for (int i = 0; i < 256; ++i)
+            all[static_cast<std::size_t>(i)] =
+                note(static_cast<std::int8_t>(i - 128), static_cast<std::int8_t>(i % 7 - 3));
+        std::array<note, 256> moved{};
+        std::array<std::int8_t, 256> midi{}, pcs{};
+        transpose_notes(all, P5, moved);
+        midi_pitches(all, midi);
+        pitch_classes(all, pcs);
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            const auto &n = all[i];
+            auto pitch = ((n.get_fifth() * 7) % 12 + 12) % 12;
+            expect(moved[i] == n + P5);
+            expect(midi[i] == n.get_midi_pitch());
+            expect(pcs[i] == pitch);
+            expect(n.get_pitch() == pitch);
+        }
+        for (auto pref : {accidental_preference::natural, accidental_preference::sharp,
+                          accidental_preference::flat}) {
+            auto copy = all;
+            simplify_notes(copy, pref);
+            for (std::size_t i = 0; i < all.size(); ++i) {
+                expect(copy[i] == all[i].simplify(pref));
+                expect(copy[i].get_midi_pitch() == all[i].get_midi_pitch());
+            }
+        }
+    };
+
     "note operator<<"_test = [] {
         std::ostringstream oss;
         oss << C(4);
@@ -0,0 +1,124 @@
+#include <boost/ut.hpp>
+#include <musicpp/onset_index.hpp>
+#include <array>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::durations;
+    using namespace musicpp::chord_patterns;
+    using namespace musicpp::time_signatures;
+
+    "onsets of a melody"_test = [] {
+        auto m = C(4) * q | D(4) * eighth.triplet() | E(4) * eighth.triplet()
+               | F(4) * eighth.triplet() | rest(h) | G(4) * duration{1, 5};
+        auto index = m.onsets();
+        expect(index.size() == 6_u);
+        expect(index.onset(0) == duration{0, 1});
+        expect(index.onset(2) == duration{1, 4} + eighth.triplet());
+        expect(index.onset(4) == half);
+        expect(index.total_duration() == m.total_duration());
+        expect(index.position(5, common).bar == 1_i);
+        expect(index.position(5, waltz).offset == duration{1, 4});
+    };
+
+    "seek finds the sounding event"_test = [] {
+        auto m = C(4) * q | D(4) * eighth.triplet() | E(4) * eighth.triplet()
+               | F(4) * eighth.triplet() | rest(h) | G(4) * duration{1, 5};
+        auto index = m.onsets();
+        expect(index.seek(duration{0, 1}) == 0_u);
+        expect(index.seek(duration{1, 5}) == 0_u);
+        expect(index.seek(duration{1, 4}) == 1_u);
+        expect(index.seek(duration{1, 3}) == 2_u);
+        expect(index.seek(duration{5, 12}) == 3_u);
+        expect(index.seek(duration{7, 8}) == 4_u);
+        expect(index.seek(duration{1, 1}) == 5_u);
+        expect(index.seek(duration{6, 5}) == index.size());
+        expect(index.seek(duration{-1, 64}) == index.size());
+        expect(index.seek(metric_position{1, {1, 10}}, common) == 5_u);
+        expect(index.seek(metric_position{1, {1, 12}}, waltz) == 4_u);
+    };
+
+    "queries far past the end do not overflow"_test = [] {
+        auto m = C(4) * duration{1, 7919} | D(4) * duration{1, 7907}
+               | E(4) * duration{1, 7901};
+        auto index = m.onsets();
+        const wide_duration far{std::int64_t{1} << 40, 3};
+        expect(index.seek(far) == index.size());
+        expect(index.seek(wide_duration{-(std::int64_t{1} << 40), 3}) == index.size());
+        expect(index.seek(duration{1, 7908}) == 1_u);
+        expect(index.overlapping(duration{1, 7908}, far) == event_range{1, 3});
+        expect(index.starting_in(duration{1, 7908}, far) == event_range{2, 3});
+        std::array<wide_duration, 3> times{wide_duration{}, far, duration{1, 7908}};
+        std::array<std::size_t, 3> hits{};
+        index.seek(times, hits);
+        expect(hits == std::array<std::size_t, 3>{0, 3, 1});
+    };
+
+    "seek into a long sequence"_test = [] {
+        melody<3000> m{};
+        for (std::size_t i = 0; i < m.events.size(); ++i)
+            m.events[i] = C(4) * (i % 3 == 0 ? q : eighth.triplet());
+        auto index = m.onsets();
+        auto target = metric_position{100, {0, 1}};
+        auto i = index.seek(target, common);
+        expect(i == 720_u);
+        expect(index.position(i, common) == target);
+        expect(index.seek(target.advanced(duration{1, 4}, common), common) == 721_u);
+        expect(index.seek(target.advanced(duration{1, 3}, common), common) == 722_u);
+    };
+
+    "chord sequence onsets"_test = [] {
+        auto seq = (C(4) + major_triad) * h.dotted() | (G(3) + dom7) * q
+                 | (A(3) + minor_triad) * w;
+        auto index = seq.onsets();
+        expect(index.size() == 3_u);
+        expect(index.onset(2) == whole);
+        expect(index.seek(duration{15, 16}) == 1_u);
+        expect(index.seek(duration{3, 2}) == 2_u);
+
+        onset_index empty;
+        expect(empty.empty());
+        expect(empty.seek(duration{0, 1}) == 0_u);
+    };
+
+    "range queries"_test = [] {
+        auto m = C(4) * q | D(4) * eighth.triplet() | E(4) * eighth.triplet()
+               | F(4) * eighth.triplet() | rest(h) | G(4) * duration{1, 5};
+        auto index = m.onsets();
+        expect(index.overlapping(duration{0, 1}, duration{6, 5}) == event_range{0, 6});
+        expect(index.overlapping(duration{1, 4}, duration{1, 3}) == event_range{1, 2});
+        expect(index.overlapping(duration{1, 5}, duration{3, 10}) == event_range{0, 2});
+        expect(index.overlapping(duration{3, 4}, duration{2, 1}) == event_range{4, 6});
+        expect(index.overlapping(duration{2, 1}, duration{3, 1}).empty());
+        expect(index.overlapping(duration{1, 2}, duration{1, 2}).empty());
+        expect(index.starting_in(duration{1, 5}, duration{1, 2}) == event_range{1, 4});
+        expect(index.starting_in(duration{1, 4}, duration{1, 2}).size() == 3_u);
+        expect(index.starting_in(duration{11, 12}, duration{1, 1}).empty());
+        expect(index.starting_in(duration{-1, 1}, duration{1, 1}) == event_range{0, 5});
+    };
+
+    "batch seek matches scalar seek"_test = [] {
+        melody<1200> m{};
+        for (std::size_t i = 0; i < m.events.size(); ++i)
+            m.events[i] = C(4) * (i % 4 == 0 ? q.dotted() : (i % 4 == 1 ? eighth : eighth.triplet()));
+        auto index = m.onsets();
+
+        std::vector<wide_duration> times;
+        for (int k = -2; k < 1200; k += 3)
+            times.push_back(wide_duration{k, 7});
+        times.push_back(wide_duration{5, 3});
+        std::vector<std::size_t> hits(times.size());
+        expect(index.seek(times, hits).size() == times.size());
+        for (std::size_t k = 0; k < times.size(); ++k)
+            expect(hits[k] == index.seek(times[k]));
+
+        std::vector<ticks> tick_times{ticks{0}, ticks{1440}, ticks{1920}, ticks{99999999}, ticks{500}};
+        std::array<std::size_t, 5> tick_hits{};
+        index.seek(tick_times, timebase{}, tick_hits);
+        expect(tick_hits == std::array<std::size_t, 5>{0, 1, 2, index.size(), 0});
+        expect(index.seek(ticks{1440}, timebase{}) == 1_u);
+    };
+}
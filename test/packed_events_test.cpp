@@ -0,0 +1,120 @@
+#include <boost/ut.hpp>
+#include <musicpp/packed_events.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::durations;
+    using namespace musicpp::chord_patterns;
+    using namespace std::literals;
+
+    "packed event layout"_test = [] {
+        static_assert(sizeof(packed_event) == 4);
+        constexpr packed_event ev{Bb(3), 0x3fff, true, true};
+        static_assert(ev.pitch() == Bb(3));
+        static_assert(ev.duration_index() == 0x3fff);
+        static_assert(ev.is_rest() && ev.is_tied());
+        constexpr packed_event extreme{note(-128, 127), 5, false, false};
+        static_assert(extreme.pitch() == note(-128, 127));
+        static_assert(!extreme.is_rest() && !extreme.is_tied());
+    };
+
+    "duration table interns values"_test = [] {
+        duration_table table;
+        expect(table[table.intern(q)] == q);
+        expect(table.intern(duration{2, 8}) == table.intern(q));
+        auto before = table.size();
+        auto odd = table.intern(duration{5, 7});
+        expect(table.size() == before + 1);
+        expect(table[odd] == duration{5, 7});
+        expect(table.find(duration{5, 7}) == odd);
+        expect(!table.find(duration{7, 5}).has_value());
+        expect(table.intern(duration{-3, 4}) != table.intern(duration{3, 4}));
+    };
+
+    "duration table is bounded"_test = [] {
+        duration_table table;
+        for (int i = 1; table.size() < duration_table::max_size; ++i)
+            (void)table.intern(duration{i, 32749});
+        expect(throws<std::length_error>([&] { (void)table.intern(duration{1, 32719}); }));
+        expect(table.size() == duration_table::max_size);
+        expect(table.intern(q) == 0_u);
+    };
+
+    "melody round trip"_test = [] {
+        auto m = (C(4) * q) | rest(eighth) | (Fs(5) * duration{3, 16}).tied() |
+                 (note(-20, 9) * duration{7, 12});
+        packed_melody packed;
+        packed.append(m);
+        expect(packed.size() == 4_u);
+        expect(packed.packed().size_bytes() == 16_u);
+        for (std::size_t i = 0; i < m.size(); ++i) {
+            auto ev = packed[i];
+            expect(ev.pitch == m[i].pitch && ev.dur == m[i].dur);
+            expect(ev.is_rest == m[i].is_rest && ev.is_tied == m[i].is_tied);
+        }
+        auto back = packed.to_melody<4>();
+        expect(back.str() == m.str());
+        expect(throws<std::out_of_range>([&] { (void)packed.to_melody<4>(1); }));
+    };
+
+    "melody iteration unpacks lazily"_test = [] {
+        packed_melody packed;
+        for (int i = 0; i < 100; ++i)
+            packed.push_back(note(static_cast<std::int8_t>(i % 12), 4) * (i % 3 ? q : h));
+        auto halves = std::count_if(packed.begin(), packed.end(),
+                                    [](const melody_event &ev) { return ev.dur == h; });
+        expect(halves == 34_i);
+        auto it = packed.begin() + 10;
+        expect((*it).pitch == note(10, 4));
+        expect(packed.end() - it == 90_i);
+        expect(it[2].pitch == note(0, 4));
+        static_assert(std::random_access_iterator<packed_melody::iterator>);
+    };
+
+    "chord round trip"_test = [] {
+        auto seq = ((D(3) + min7) * h) | ((G(2) + dom9) * q).tied() | (chord_rest(q)) |
+                   ((C(3) + major_triad) * w);
+        packed_chords packed;
+        packed.append(seq);
+        expect(packed.size() == 4_u);
+        expect(packed.packed().size() == 2u * 4u + 4u + 5u + 1u + 3u);
+
+        std::vector<std::size_t> sizes;
+        for (auto view : packed)
+            sizes.push_back(view.size());
+        expect(sizes == std::vector<std::size_t>{4, 5, 1, 3});
+
+        auto it = packed.begin();
+        auto dm7 = (*it).unpack<4>();
+        expect(dm7.chord.notes == (D(3) + min7).notes);
+        expect(dm7.dur == h);
+        ++it;
+        expect((*it).is_tied() && !(*it).is_rest());
+        expect((*it)[4] == (G(2) + dom9)[4]);
+        expect(throws<std::invalid_argument>([&] { (void)(*it).unpack<4>(); }));
+        ++it;
+        expect((*it).is_rest() && (*it).dur() == q);
+        ++it;
+        expect((*it).unpack<3>().str() == ((C(3) + major_triad) * w).str());
+        ++it;
+        expect(it == packed.end());
+    };
+
+    "containers share nothing"_test = [] {
+        packed_chords a;
+        a.push_back((C(4) + major_triad) * duration{5, 7});
+        packed_chords b;
+        b.push_back((C(4) + major_triad) * q);
+        expect((*a.begin()).dur() == duration{5, 7});
+        expect((*b.begin()).dur() == q);
+        a.clear();
+        expect(a.empty() && a.begin() == a.end());
+    };
+}
@@ -0,0 +1,110 @@
+#include <boost/ut.hpp>
+#include <musicpp/chord_sequence.hpp>
+#include <musicpp/melody.hpp>
+#include <musicpp/parallel.hpp>
+#include <musicpp/scales.hpp>
+#include <stdexcept>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::intervals;
+    using namespace musicpp::durations;
+    using namespace musicpp::chord_patterns;
+    using namespace musicpp::scale_patterns;
+    using namespace std::literals;
+
+    "parallel map keeps input order"_test = [] {
+        std::vector<int> items(10000);
+        for (std::size_t i = 0; i < items.size(); ++i)
+            items[i] = static_cast<int>(i);
+        for (std::size_t threads : {1u, 2u, 7u}) {
+            auto out = parallel_map(std::span<const int>{items},
+                                    [](int x) { return x * 2; },
+                                    {.threads = threads, .grain = 3});
+            expect(out.size() == items.size());
+            bool ordered = true;
+            for (std::size_t i = 0; i < out.size(); ++i)
+                ordered = ordered && out[i] == items[i] * 2;
+            expect(ordered);
+        }
+    };
+
+    "parallel map uses per-thread scratch"_test = [] {
+        struct scratch {
+            std::vector<int> buffer;
+        };
+        std::vector<int> items(500, 3);
+        auto out = parallel_map<scratch>(
+            std::span<const int>{items},
+            [](scratch &s, int x) {
+                s.buffer.assign(static_cast<std::size_t>(x), 1);
+                return s.buffer.size();
+            },
+            {.threads = 4});
+        expect(std::ranges::all_of(out, [](std::size_t n) { return n == 3; }));
+    };
+
+    "parallel map propagates exceptions"_test = [] {
+        std::vector<int> items(1000);
+        items[517] = 1;
+        expect(throws<std::runtime_error>([&] {
+            (void)parallel_map(std::span<const int>{items},
+                               [](int x) {
+                                   if (x)
+                                       throw std::runtime_error("bad");
+                                   return x;
+                               },
+                               {.threads = 4});
+        }));
+    };
+
+    "parallel names and roman numerals"_test = [] {
+        auto song = (D(4) + min7) * q | (G(3) + dom7) * q | (C(4) + maj7) * h;
+        std::vector<decltype(song)> tracks(64, song);
+        auto key = C(4) + major;
+        auto names = parallel_names(std::span<const decltype(song)>{tracks},
+                                    {.threads = 4});
+        auto roman = parallel_roman(std::span<const decltype(song)>{tracks},
+                                    key, {.threads = 4});
+        expect(names.size() == 64_u);
+        expect(std::ranges::all_of(names, [&](const auto &n) {
+            return n == song.names();
+        }));
+        expect(std::ranges::all_of(roman, [&](const auto &r) {
+            return r == song.roman(key);
+        }));
+    };
+
+    "parallel melodies"_test = [] {
+        auto tune = C(4) * q | E(4) * q | G(4) * h;
+        std::vector<decltype(tune)> tunes(100, tune);
+        auto ranges = parallel_map(std::span<const decltype(tune)>{tunes},
+                                   [](const auto &m) { return m.range(); });
+        expect(std::ranges::all_of(ranges, [&](auto iv) { return iv == tune.range(); }));
+    };
+
+    "parallel batch analysis"_test = [] {
+        std::vector<chord_instance<4>> chords;
+        for (int i = 0; i < 1000; ++i) {
+            auto root = C(4) + interval(static_cast<std::int8_t>(i % 12 - 5), 0);
+            chords.push_back(root + (i % 3 ? min7 : dom7));
+        }
+        auto serial = analyze_batch(std::span<const chord_instance<4>>{chords});
+        auto parallel = analyze_batch(std::span<const chord_instance<4>>{chords},
+                                      parallel_options{.threads = 3, .grain = 1});
+        expect(parallel.size() == serial.size());
+        bool same = true;
+        for (std::size_t i = 0; i < serial.size(); ++i)
+            same = same && parallel[i].str() == serial[i].str();
+        expect(same);
+    };
+
+    "parallel empty input"_test = [] {
+        std::vector<int> items;
+        auto out = parallel_map(std::span<const int>{items}, [](int x) { return x; });
+        expect(out.empty());
+    };
+}
@@ -0,0 +1,95 @@
+#include <boost/ut.hpp>
+#include <musicpp/chords.hpp>
+#include <musicpp/pitch_class_set.hpp>
+#include <array>
+#include <format>
+#include <string_view>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::chord_patterns;
+    using namespace std::literals;
+
+    "set operations"_test = [] {
+        pitch_class_set c_major{0, 4, 7};
+        expect(c_major.size() == 3_u);
+        expect(c_major.contains(4) && !c_major.contains(3));
+        expect(c_major.contains(16));
+        expect(c_major.transpose(2) == pitch_class_set{2, 6, 9});
+        expect(c_major.transpose(-1) == pitch_class_set{11, 3, 6});
+        expect(c_major.invert() == pitch_class_set{0, 8, 5});
+        expect(c_major.invert(7) == pitch_class_set{7, 3, 0});
+        expect((c_major | pitch_class_set{11}) == pitch_class_set{0, 4, 7, 11});
+        expect((c_major & pitch_class_set{4, 5}) == pitch_class_set{4});
+        expect((c_major - pitch_class_set{0}) == pitch_class_set{4, 7});
+        expect(c_major.complement().size() == 9_u);
+        expect(pitch_class_set(std::uint16_t{0xffff}).size() == 12_u);
+
+        pitch_class_set s;
+        s.insert(1).insert(13).insert(2).erase(-10);
+        expect(s == pitch_class_set{1});
+    };
+
+    "chords expose their pitch classes"_test = [] {
+        auto g7 = G(3) + dom7;
+        expect(g7.pitch_classes() == pitch_class_set{7, 11, 2, 5});
+        expect(g7.pitch_classes().forte_name() == "4-27"sv);
+        expect((C(4) + half_dim7).pitch_classes().same_set_class(g7.pitch_classes()));
+    };
+
+    "prime form and Forte names"_test = [] {
+        expect(pitch_class_set{0, 4, 7}.prime_form() == pitch_class_set{0, 3, 7});
+        expect(pitch_class_set{0, 3, 7}.forte_name() == "3-11"sv);
+        expect(pitch_class_set{0, 4, 8}.forte_name() == "3-12"sv);
+        expect(pitch_class_set{0, 3, 6, 9}.forte_name() == "4-28"sv);
+        expect(pitch_class_set{0, 2, 4, 5, 7, 9, 11}.forte_name() == "7-35"sv);
+        expect(pitch_class_set{0, 2, 4, 6, 8, 10}.forte_name() == "6-35"sv);
+        expect(pitch_class_set{0, 1, 4, 5, 8, 9}.forte_name() == "6-20"sv);
+        expect(pitch_class_set{}.forte_name() == "0-1"sv);
+        expect(pitch_class_set{5}.forte_name() == "1-1"sv);
+        expect(pitch_class_set{2, 8}.forte_name() == "2-6"sv);
+        expect(pitch_class_set{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}.forte_name() == "12-1"sv);
+        expect(pitch_class_set{0, 2, 4, 5, 7, 9, 11}.forte_ordinal() == 35_i);
+    };
+
+    "interval vectors and Z relations"_test = [] {
+        auto major_scale = pitch_class_set{0, 2, 4, 5, 7, 9, 11};
+        expect(major_scale.interval_vector() == std::array<std::uint8_t, 6>{2, 5, 4, 3, 6, 1});
+        auto all_interval = pitch_class_set{0, 1, 4, 6};
+        expect(all_interval.forte_name() == "4-Z15"sv);
+        expect(all_interval.interval_vector() == std::array<std::uint8_t, 6>{1, 1, 1, 1, 1, 1});
+        expect(all_interval.z_correspondent() == pitch_class_set{0, 1, 3, 7});
+        expect(all_interval.is_z_related(pitch_class_set{0, 1, 3, 7}.transpose(5)));
+        expect(!all_interval.is_z_related(all_interval));
+        expect(!pitch_class_set{0, 4, 7}.z_correspondent().has_value());
+        expect(pitch_class_set{0, 1, 2, 3, 5, 6}.z_correspondent()->forte_name() == "6-Z36"sv);
+    };
+
+    "Forte catalogue is consistent"_test = [] {
+        std::array<int, 13> classes{};
+        for (unsigned bits = 0; bits < 4096; ++bits) {
+            pitch_class_set s(static_cast<std::uint16_t>(bits));
+            auto prime = s.prime_form();
+            if (prime == s)
+                ++classes[s.size()];
+            expect(prime.contains(0) || s.empty());
+            expect(prime.same_set_class(s.transpose(static_cast<int>(bits % 12)).invert()));
+            expect(s.interval_vector() == prime.interval_vector());
+            if (!s.empty() && s.size() < 12) {
+                auto name = s.complement().forte_name();
+                expect(name.substr(name.find('-')) == s.forte_name().substr(s.forte_name().find('-')) ||
+                       s.size() == 6);
+            }
+        }
+        expect(classes == std::array<int, 13>{1, 1, 6, 12, 29, 38, 50, 38, 29, 12, 6, 1, 1});
+    };
+
+    "formatting"_test = [] {
+        constexpr pitch_class_set s{0, 4, 7, 10, 11};
+        static_assert(s.prime_form().forte_name() == s.forte_name());
+        expect(s.str() == "{0,4,7,10,11}"s);
+        expect(std::format("{:>15}", s) == "  {0,4,7,10,11}"s);
+    };
+}
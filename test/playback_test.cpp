@@ -0,0 +1,153 @@
+#include <boost/ut.hpp>
+#include <musicpp/playback.hpp>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::durations;
+    using namespace musicpp::chord_patterns;
+    using namespace std::chrono_literals;
+
+    constexpr auto on = playback_kind::note_on;
+    constexpr auto off = playback_kind::note_off;
+
+    "melody events"_test = [&] {
+        auto m = (C(4) * q) | rest(q) | (E(4) * q).tied() | (E(4) * q) | (E(4) * h);
+        auto events = playback_events(m, tempo{120});
+        std::vector<playback_event> expected{
+            {0.0, C(4), on}, {0.5, C(4), off}, {1.0, E(4), on},
+            {2.0, E(4), off}, {2.0, E(4), on}, {3.0, E(4), off}};
+        expect(events == expected);
+    };
+
+    "chord events and ties"_test = [&] {
+        auto seq = ((C(4) + major_triad) * h).tied() | ((C(4) + sus4) * h)
+                 | chord_rest(q);
+        auto events = playback_events(seq, tempo{60});
+        expect(events.size() == 8_u);
+        std::size_t ons_at_start = 0;
+        for (const auto &ev : events)
+            ons_at_start += ev.time == 0.0 && ev.kind == on;
+        expect(ons_at_start == 3_u);
+        expect(events[3] == playback_event{2.0, E(4), off});
+        expect(events[4] == playback_event{2.0, F(4), on});
+        expect(events.back().time == 4.0);
+    };
+
+    "tempo maps shape event times"_test = [&] {
+        auto m = (C(4) * w) | (D(4) * w);
+        tempo_map map{tempo{120}};
+        map.set_tempo(whole, tempo{60});
+        auto events = playback_events(m, map);
+        expect(events[1].time == 2.0);
+        expect(events[3].time == 6.0);
+    };
+
+    "spsc ring preserves order across threads"_test = [] {
+        detail::spsc_ring<std::uint32_t> ring(64);
+        expect(ring.capacity() == 64_u);
+        constexpr std::uint32_t count = 200000;
+        std::thread producer([&] {
+            for (std::uint32_t i = 0; i < count; ++i)
+                while (!ring.try_push(i))
+                    std::this_thread::yield();
+        });
+        std::uint32_t expected = 0;
+        bool ordered = true;
+        while (expected < count) {
+            std::uint32_t v;
+            if (ring.try_pop(v))
+                ordered = ordered && v == expected++;
+        }
+        producer.join();
+        std::uint32_t v;
+        expect(ordered);
+        expect(!ring.try_pop(v));
+    };
+
+    "scheduler delivers every event on time"_test = [&] {
+        std::vector<playback_event> events;
+        for (int i = 0; i < 200; ++i) {
+            events.push_back({i * 0.001, note(static_cast<std::int8_t>(i % 12), 4), on});
+            events.push_back({i * 0.001 + 0.0005, note(static_cast<std::int8_t>(i % 12), 4), off});
+        }
+        playback_scheduler scheduler{playback_recorder(events.size()),
+                                     playback_options{.queue_capacity = 16, .lookahead = 5ms}};
+        scheduler.start(events);
+        scheduler.wait();
+
+        const auto &records = scheduler.sink().records();
+        expect(records.size() == events.size());
+        bool in_order = true;
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            in_order = in_order && records[i].event == events[i];
+            auto due = scheduler.start_time() +
+                       std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                           std::chrono::duration<double>(events[i].time));
+            in_order = in_order && records[i].delivered >= due;
+        }
+        expect(in_order);
+        const auto &stats = scheduler.stats();
+        expect(stats.count == events.size());
+        expect(stats.min >= 0ns);
+        expect(stats.mean() <= stats.max);
+    };
+
+    "stop cancels pending events"_test = [&] {
+        std::vector<playback_event> events{{0.0, C(4), on}, {30.0, C(4), off}};
+        playback_scheduler scheduler{playback_recorder{}, playback_options{.lookahead = 1ms}};
+        scheduler.start(events);
+        std::this_thread::sleep_for(50ms);
+        auto before = std::chrono::steady_clock::now();
+        scheduler.stop();
+        expect(std::chrono::steady_clock::now() - before < 1s);
+        expect(scheduler.sink().records().size() == 2_u);
+        expect(throws<std::invalid_argument>([&] {
+            scheduler.start({{1.0, C(4), on}, {0.5, C(4), off}});
+        }));
+    };
+
+    "stop releases sounding notes"_test = [&] {
+        std::vector<playback_event> events{{0.0, C(4), on}, {0.0, E(4), on},
+                                           {0.0, G(4), on}, {0.01, E(4), off},
+                                           {30.0, C(4), off}, {30.0, G(4), off}};
+        playback_scheduler scheduler{playback_recorder{}, playback_options{.lookahead = 1ms}};
+        scheduler.start(events);
+        std::this_thread::sleep_for(100ms);
+        scheduler.stop();
+
+        const auto &records = scheduler.sink().records();
+        expect(records.size() == 6_u);
+        expect(scheduler.stats().count == 4_u);
+        if (records.size() == 6) {
+            expect(records[3].event == events[3]);
+            expect(records[4].event.pitch == G(4) && records[4].event.kind == off);
+            expect(records[5].event.pitch == C(4) && records[5].event.kind == off);
+            expect(records[5].event.time >= 0.09 && records[5].event.time < 1.0);
+        }
+    };
+
+    "restart does not replay a cancelled run"_test = [&] {
+        playback_scheduler scheduler{playback_recorder{},
+                                     playback_options{.lookahead = 1s}};
+        scheduler.start({{0.0, C(4), on}, {0.2, D(4), on}, {0.3, E(4), on}});
+        std::this_thread::sleep_for(1050ms);
+        scheduler.stop();
+        const auto first = scheduler.sink().records().size();
+        expect(first == 2_u);
+
+        scheduler.start({{0.0, G(4), on}, {0.05, G(4), off}});
+        scheduler.wait();
+        const auto &records = scheduler.sink().records();
+        expect(records.size() == first + 2);
+        if (records.size() == first + 2) {
+            expect(records[first].event == playback_event{0.0, G(4), on});
+            expect(records[first + 1].event == playback_event{0.05, G(4), off});
+        }
+    };
+}
@@ -0,0 +1,129 @@
+#include <boost/ut.hpp>
+#include <musicpp/quantizer.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::durations;
+    using namespace musicpp::time_signatures;
+    using namespace std::literals;
+
+    auto line = [](const std::vector<melody_event> &events) {
+        std::string s;
+        for (const auto &ev : events) {
+            if (!s.empty())
+                s += ' ';
+            s += ev.str();
+        }
+        return s;
+    };
+
+    "straight notes snap to the duple grid"_test = [&] {
+        std::vector<performed_note> take{
+            {0.01, 0.49, C(4)}, {0.52, 0.74, D(4)}, {0.74, 1.02, E(4)},
+            {1.49, 2.51, F(4)}};
+        auto events = quantize(take, tempo{120}, common);
+        expect(line(events) == "C4(q) D4(8th) E4(8th) -(q) F4(q)~ F4(q)"s);
+    };
+
+    "triplets are detected per beat"_test = [&] {
+        std::vector<performed_note> take{
+            {0.00, 0.16, C(4)}, {0.17, 0.33, D(4)}, {0.34, 0.49, E(4)},
+            {0.50, 1.00, F(4)}};
+        auto events = quantize(take, tempo{120}, common);
+        expect(events.size() == 4_u);
+        expect(events[0].dur == eighth.triplet());
+        expect(events[2].dur == eighth.triplet());
+        expect(events[3].dur == quarter);
+
+        auto duple_only = quantize(take, tempo{120}, common, {.tuplet_subdivisions = 0});
+        for (const auto &ev : duple_only)
+            expect((wide_duration{ev.dur} * 16).reduced().den == 1_i);
+    };
+
+    "dotted rhythms and ties"_test = [&] {
+        std::vector<performed_note> take{
+            {0.0, 0.37, G(4)}, {0.375, 0.5, A(4)}, {0.5, 1.63, B(4)}};
+        auto events = quantize(take, tempo{120}, common);
+        expect(events[0].dur == eighth.dotted());
+        expect(events[1].dur == sixteenth);
+        expect(line(events) == "G4(8th.) A4(16th) B4(h)~ B4(16th)"s);
+
+        auto raw = quantize(take, tempo{120}, common, {.split_unnotatable = false});
+        expect(raw.back().dur == duration{9, 16});
+    };
+
+    "other tuplet grids notate their own steps"_test = [&] {
+        std::vector<performed_note> take;
+        for (int i = 0; i < 10; ++i)
+            take.push_back({i * 0.1, i * 0.1 + 0.09, note(static_cast<std::int8_t>(i % 7), 4)});
+        take.push_back({1.0, 1.3, C(5)});
+        take.push_back({1.3, 1.5, D(5)});
+        auto events = quantize(take, tempo{120}, common, {.tuplet_subdivisions = 5});
+        expect(events.size() == 12_u);
+        for (std::size_t i = 0; i < 10 && i < events.size(); ++i)
+            expect(events[i].dur == duration{1, 20} && !events[i].is_tied);
+        if (events.size() == 12) {
+            expect(events[10].dur == duration{3, 20} && !events[10].is_tied);
+            expect(events[11].dur == duration{1, 10});
+        }
+    };
+
+    "long values are tied across barlines"_test = [&] {
+        std::vector<performed_note> whole_take{{0.0, 10.0, C(4)}};
+        expect(line(quantize(whole_take, tempo{120}, common)) ==
+               "C4(w)~ C4(w)~ C4(w)~ C4(w)~ C4(w)"s);
+        std::vector<performed_note> late_take{{1.0, 4.0, D(4)}};
+        expect(line(quantize(late_take, tempo{120}, common)) == "-(h) D4(h)~ D4(w)"s);
+        std::vector<performed_note> waltz_take{{0.0, 3.0, E(4)}};
+        expect(line(quantize(waltz_take, tempo{120}, waltz)) == "E4(h.)~ E4(h.)"s);
+    };
+
+    "switching grids costs extra"_test = [&] {
+        std::vector<performed_note> take;
+        for (int i = 0; i < 12; ++i) {
+            double onset = i / 6.0 + (i % 3 == 1 ? 0.02 : 0.0);
+            take.push_back({onset, onset + 0.15, C(4)});
+        }
+        auto events = quantize(take, tempo{120}, common);
+        for (const auto &ev : events)
+            expect(ev.dur == eighth.triplet());
+    };
+
+    "overlaps, short notes and gaps"_test = [&] {
+        std::vector<performed_note> take{
+            {1.0, 1.49, E(4)}, {0.0, 0.7, C(4)}, {0.5, 0.51, D(4)}};
+        auto events = quantize(take, tempo{120}, common);
+        expect(line(events) == "C4(q) D4(16th) -(8th.) E4(q)"s);
+    };
+
+    "long takes stay aligned"_test = [] {
+        std::vector<performed_note> take;
+        std::uint32_t seed = 11;
+        for (int i = 0; i < 4000; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            double jitter = (static_cast<int>(seed >> 24) % 21 - 10) / 1000.0;
+            take.push_back({i * 0.25 + jitter, i * 0.25 + 0.2, note(static_cast<std::int8_t>(i % 7), 4)});
+        }
+        auto events = quantize(take, tempo{120}, common);
+        expect(events.size() == 4000_u);
+        wide_duration total;
+        for (const auto &ev : events) {
+            total += ev.dur;
+            expect(ev.dur == eighth);
+        }
+        expect(total == wide_duration{500, 1});
+    };
+
+    "empty and invalid input"_test = [] {
+        expect(quantize({}, tempo{120}, common).empty());
+        std::vector<performed_note> take{{0.0, 1.0, C(4)}};
+        expect(throws<std::invalid_argument>([&] {
+            (void)quantize(take, tempo{120}, common, {.subdivisions = 0});
+        }));
+    };
+}
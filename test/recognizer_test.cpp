@@ -0,0 +1,107 @@
+#include <boost/ut.hpp>
+#include <musicpp/recognizer.hpp>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::intervals;
+    using namespace musicpp::chord_patterns;
+    using namespace std::literals;
+
+    "recognizer builds chord note by note"_test = [] {
+        chord_recognizer r;
+        expect(!r.current().has_value());
+        expect(r.note_on(C(4)));
+        expect(r.current()->str() == "C5(no5)"s);
+        expect(r.note_on(E(4)));
+        expect(r.note_on(G(4)));
+        expect(r.current()->str() == "C"s);
+        expect(r.note_on(B(4)));
+        expect(r.current()->str() == "Cmaj7"s);
+        expect(r.sounding() == 4_u);
+        expect(r.bass()->str() == "C4"s);
+    };
+
+    "recognizer matches static analysis"_test = [] {
+        chord_instance<4> chords[] = {C(4) + maj7, D(4) + min7,
+                                      G(3) + dom7, B(3) + half_dim7,
+                                      C(4) + maj7.inversion<2>()};
+        for (const auto &chord : chords) {
+            chord_recognizer r;
+            for (const auto &n : chord.notes)
+                (void)r.note_on(n);
+            expect(r.interpretations().str() == chord.analyze().str());
+        }
+    };
+
+    "recognizer only reports changes"_test = [] {
+        chord_recognizer r;
+        (void)r.note_on(C(3));
+        (void)r.note_on(E(3));
+        expect(r.note_on(G(3)));
+        expect(!r.note_on(C(4)));
+        expect(!r.note_on(G(4)));
+        expect(!r.note_off(G(4)));
+        expect(!r.note_on(C(3)));
+        expect(!r.note_off(C(3)));
+        expect(r.current()->str() == "C"s);
+        expect(r.note_off(C(3)));
+        expect(r.current()->str() == "C/E"s);
+    };
+
+    "recognizer tracks bass"_test = [] {
+        chord_recognizer r;
+        (void)r.note_on(C(4));
+        (void)r.note_on(G(4));
+        expect(r.note_on(E(3)));
+        expect(r.current()->str() == "C/E"s);
+        expect(r.bass()->str() == "E3"s);
+        expect(r.note_off(E(3)));
+        expect(r.bass()->str() == "C4"s);
+    };
+
+    "recognizer keeps spelling"_test = [] {
+        chord_recognizer r;
+        (void)r.note_on(Db(4));
+        (void)r.note_on(F(4));
+        (void)r.note_on(Ab(4));
+        expect(r.current()->str() == "Db"s);
+    };
+
+    "recognizer all notes off"_test = [] {
+        chord_recognizer r;
+        for (auto n : (C(4) + major_triad).notes)
+            (void)r.note_on(n);
+        expect(r.all_notes_off());
+        expect(!r.current().has_value());
+        expect(r.sounding() == 0_u);
+        expect(r.pitch_classes() == 0_u);
+        expect(!r.note_off(C(4)));
+    };
+
+    "recognizer with custom dictionary"_test = [] {
+        chord_dictionary_builder builder;
+        builder.add("quartal", chord_pattern<3>{{P1, P4, m7}});
+        chord_recognizer r{builder.build()};
+        (void)r.note_on(D(4));
+        (void)r.note_on(G(4));
+        expect(r.note_on(C(5)));
+        expect(r.current()->str() == "Dquartal"s);
+    };
+
+    "large dictionary keeps every interpretation"_test = [] {
+        chord_dictionary_builder builder;
+        for (std::size_t i = 0; i <= detail::max_interpretations; ++i)
+            builder.add("7/" + std::to_string(i), dom7);
+        auto dict = builder.build();
+        chord_recognizer r{dict};
+        auto chord = G(3) + dom7;
+        for (auto n : chord.notes)
+            (void)r.note_on(n);
+        auto expected = chord.analyze(dict);
+        expect(r.interpretations().size() == expected.size());
+        expect(r.interpretations().size() > detail::max_interpretations);
+        expect(r.interpretations().str() == expected.str());
+    };
+}
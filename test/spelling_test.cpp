@@ -0,0 +1,109 @@
+#include <boost/ut.hpp>
+#include <musicpp/spelling.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::durations;
+    using namespace std::literals;
+
+    auto names = [](std::span<const note> ns) {
+        std::string s;
+        for (const auto &n : ns) {
+            if (!s.empty())
+                s += ' ';
+            s += n.str();
+        }
+        return s;
+    };
+
+    "sharp keys are spelled with sharps"_test = [&] {
+        std::array<note, 8> line{E(4), Gb(4), Ab(4), A(4), B(4), Db(5), Eb(5), E(5)};
+        spell_notes(line);
+        expect(names(line) == "E4 F#4 G#4 A4 B4 C#5 D#5 E5"s);
+    };
+
+    "flat keys are spelled with flats"_test = [&] {
+        std::array<note, 8> line{As(3), C(4), D(4), Ds(4), F(4), G(4), A(4), As(4)};
+        spell_notes(line);
+        expect(names(line) == "Bb3 C4 D4 Eb4 F4 G4 A4 Bb4"s);
+
+        std::array<note, 4> f_major{F(4), A(4), As(4), C(5)};
+        spell_notes(f_major);
+        expect(f_major[2] == Bb(4));
+    };
+
+    "spelling follows modulations"_test = [&] {
+        std::vector<note> line;
+        for (int bar = 0; bar < 3; ++bar)
+            for (auto n : {D(4), E(4), Gb(4), G(4), A(4), B(4), Db(5), D(5)})
+                line.push_back(n);
+        for (int bar = 0; bar < 3; ++bar)
+            for (auto n : {Eb(4), F(4), G(4), Gs(4), As(4), C(5), D(5), Ds(5)})
+                line.push_back(n);
+        spell_notes(line);
+        expect(line[2] == Fs(4));
+        expect(line[6] == Cs(5));
+        expect(line[line.size() - 5] == Ab(4));
+        expect(line[line.size() - 1] == Eb(5));
+    };
+
+    "sounding pitches are preserved"_test = [] {
+        std::vector<note> line;
+        std::uint32_t seed = 7;
+        for (int i = 0; i < 2000; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            line.push_back(note(static_cast<std::int8_t>(static_cast<int>(seed >> 24) % 25 - 12),
+                                static_cast<std::int8_t>(static_cast<int>(seed >> 8) % 3 + 2)));
+        }
+        auto spelled = line;
+        spell_notes(spelled);
+        for (std::size_t i = 0; i < line.size(); ++i) {
+            expect(spelled[i].get_midi_pitch() == line[i].get_midi_pitch());
+            expect(spelled[i].get_fifth() >= -15 && spelled[i].get_fifth() <= 18);
+        }
+        auto again = spelled;
+        spell_notes(again);
+        expect(again == spelled);
+    };
+
+    "options shape the result"_test = [&] {
+        std::array<note, 3> tritone{C(4), Fs(4), C(5)};
+        spell_notes(tritone);
+        expect(names(tritone) == "C4 F#4 C5"s);
+        std::array<note, 2> leap{Eb(4), Cs(5)};
+        spell_notes(leap, {.accidental_cost = 0, .key_cost = 0, .leap_cost = 1});
+        expect(leap[1] - leap[0] == intervals::m7);
+    };
+
+    "melodies keep rests and durations"_test = [] {
+        auto m = (Gb(4) * q) | rest(q) | (D(4) * h) | (Db(5) * q);
+        auto spelled = spell(m);
+        expect(spelled[0].pitch == Fs(4));
+        expect(spelled[1].is_rest && spelled[1].dur == q);
+        expect(spelled[2].pitch == D(4) && spelled[2].dur == h);
+        expect(spelled[3].pitch == Cs(5));
+    };
+
+    "spelling stays within double accidentals"_test = [&] {
+        std::array<note, 5> line{G(4), Cs(4), F(3), D(4), Db(3)};
+        spell_notes(line, {.window = 2, .accidental_cost = 0, .key_cost = 0, .leap_cost = 4});
+        for (const auto &n : line)
+            expect(detail::accidental_count(n.get_fifth()) <= 2_i) << n.str();
+        for (const auto &fifths : detail::pitch_class_spellings) {
+            for (auto f : fifths)
+                expect(detail::accidental_count(f) <= 2_i);
+        }
+    };
+
+    "empty input is fine"_test = [] {
+        std::span<note> none;
+        spell_notes(none);
+        expect(none.empty());
+    };
+}
@@ -0,0 +1,108 @@
+#include <boost/ut.hpp>
+#include <musicpp/tempo_map.hpp>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::durations;
+    using namespace musicpp::time_signatures;
+
+    auto near = [](double a, double b, double eps = 1e-9) {
+        return std::abs(a - b) <= eps * std::max(1.0, std::abs(b));
+    };
+
+    "constant map matches tempo"_test = [&] {
+        tempo_map map{tempo{90}};
+        expect(map.size() == 1_u);
+        expect(near(map.seconds(whole * 3), tempo{90}.seconds(whole * 3)));
+        expect(near(map.seconds(ticks{960}, timebase{}), 60.0 / 90.0));
+        expect(near(map.position(2.0), 0.75));
+        expect(map.tick_at(2.0, timebase{}) == ticks{2880});
+
+        tempo_map dotted{tempo{60, quarter.dotted()}};
+        expect(near(dotted.seconds(six_eight.bar_duration()), 2.0));
+    };
+
+    "step changes accumulate seconds"_test = [&] {
+        tempo_map map{tempo{120}};
+        map.set_tempo(whole * 2, tempo{60}).set_tempo(whole * 3, tempo{240});
+        expect(map.size() == 3_u);
+        expect(near(map.seconds(whole * 2), 4.0));
+        expect(near(map.seconds(duration{5, 2}), 6.0));
+        expect(near(map.seconds(whole * 4), 9.0));
+        expect(near(map.position(7.0), 2.75));
+        expect(near(map.tempo_at(duration{5, 2}).bpm, 60.0));
+        expect(near(map.tempo_at(whole * 3, half).bpm, 120.0));
+    };
+
+    "ramps integrate in closed form"_test = [&] {
+        tempo_map map{tempo{60}};
+        map.ramp(whole, whole * 2, tempo{120});
+        expect(map.size() == 3_u);
+        expect(near(map.seconds(whole), 4.0));
+        expect(near(map.seconds(whole * 2), 4.0 + 4.0 * std::log(2.0)));
+        expect(near(map.seconds(whole * 3), 4.0 + 4.0 * std::log(2.0) + 2.0));
+        expect(near(map.tempo_at(duration{3, 2}).bpm, 90.0));
+
+        double t = 0.0;
+        for (int i = 0; i < 48; ++i) {
+            double step = map.seconds(duration{i + 1, 16}) - map.seconds(duration{i, 16});
+            t += step;
+            if (i > 16 && i < 31)
+                expect(step < map.seconds(duration{i, 16}) - map.seconds(duration{i - 1, 16}));
+        }
+        expect(near(t, map.seconds(whole * 3)));
+
+        tempo_map rit{tempo{120}};
+        rit.ramp(whole * 4, whole * 6, tempo{40}).set_tempo(whole * 8, tempo{100});
+        for (double x : {0.0, 3.25, 4.5, 5.99, 6.0, 7.0, 9.75}) {
+            auto wd = wide_duration{static_cast<std::int64_t>(x * 400), 400};
+            expect(near(rit.position(rit.seconds(wd)), x, 1e-12));
+        }
+    };
+
+    "batch conversion matches scalar lookups"_test = [&] {
+        tempo_map map{tempo{100}};
+        map.ramp(whole, whole * 3, tempo{150})
+           .set_tempo(whole * 5, tempo{72})
+           .ramp(whole * 6, whole * 7, tempo{50});
+
+        std::vector<wide_duration> onsets;
+        for (int i = 0; i < 160; ++i)
+            onsets.push_back(wide_duration{i, 16});
+        onsets.push_back(wide_duration{3, 4});
+        std::vector<double> secs(onsets.size());
+        expect(map.seconds(onsets, secs).size() == onsets.size());
+        for (std::size_t i = 0; i < onsets.size(); ++i)
+            expect(secs[i] == map.seconds(onsets[i]));
+
+        std::vector<ticks> tick_onsets{ticks{0}, ticks{4000}, ticks{20000}, ticks{1000}};
+        std::array<double, 3> tick_secs{};
+        expect(map.seconds(tick_onsets, timebase{}, tick_secs).size() == 3_u);
+        for (std::size_t i = 0; i < tick_secs.size(); ++i)
+            expect(tick_secs[i] == map.seconds(tick_onsets[i], timebase{}));
+
+        std::vector<double> back(secs.size());
+        map.positions(secs, back);
+        for (std::size_t i = 0; i < secs.size(); ++i) {
+            expect(back[i] == map.position(secs[i]));
+            expect(near(back[i], detail::whole_notes(onsets[i]), 1e-12));
+        }
+    };
+
+    "invalid maps are rejected"_test = [&] {
+        expect(throws<std::invalid_argument>([] { (void)tempo_map{tempo{0}}; }));
+        tempo_map map;
+        map.set_tempo(whole * 2, tempo{80});
+        expect(throws<std::invalid_argument>([&] { map.set_tempo(whole, tempo{90}); }));
+        expect(throws<std::invalid_argument>([&] { map.ramp(whole * 3, whole * 3, tempo{90}); }));
+        expect(throws<std::invalid_argument>([&] { map.set_tempo(whole * 4, tempo{-5}); }));
+        map.set_tempo(whole * 2, tempo{60});
+        expect(map.size() == 2_u);
+        expect(near(map.seconds(whole * 3), 4.0 + 4.0));
+    };
+}
@@ -238,4 +238,84 @@ int main() {
         expect(bars[0] == 0_i);
         expect(bars[1] == 1_i);
     };
+
+    "tick lengths of bars and beats"_test = [] {
+        constexpr timebase tb;
+        static_assert(common.bar_ticks(tb) == ticks{3840});
+        static_assert(time_signature{6, 8}.beat_ticks(tb) == ticks{480});
+        expect(common.bar_count(ticks{8000}, tb) == 2_i);
+        expect(common.remainder(ticks{8000}, tb) == ticks{320});
+        expect(tempo{120}.seconds(ticks{1920}, tb) == 1.0);
+        expect(tempo{120}.seconds(ticks{960}, timebase{480}) == 1.0);
+    };
+
+    "melody tick walk matches rational walk"_test = [] {
+        constexpr timebase tb;
+        auto m = C(4) * q.dotted() | D(4) * eighth | E(4) * eighth.triplet()
+               | F(4) * eighth.triplet() | G(4) * eighth.triplet() | A(4) * q
+               | B(4) * w | C(5) * w;
+        std::vector<metric_position> rational;
+        m.walk(common, [&](const auto &, auto pos) { rational.push_back(pos); });
+        std::vector<tick_position> ticked;
+        m.walk(common, tb, [&](const auto &, auto pos) { ticked.push_back(pos); });
+        expect(ticked.size() == rational.size());
+        for (std::size_t i = 0; i < ticked.size(); ++i) {
+            expect(ticked[i].bar == rational[i].bar);
+            expect(ticked[i].metric(tb).offset == rational[i].offset);
+            expect(ticked[i].is_on_beat(common, tb) == rational[i].is_on_beat(common));
+        }
+        expect(ticked[5].beat_index(common, tb) == 3_i && !ticked[5].is_downbeat());
+        expect(ticked[6].is_downbeat() && ticked[6].bar == 1_i);
+        expect(ticked[7].beat_index(common, tb) == 0_i && ticked[7].bar == 2_i);
+        expect(ticked[2].str(tb) == rational[2].str());
+        expect(m.total_ticks(tb) == ticks{3840 * 3});
+    };
+
+    "chord_sequence tick walk"_test = [] {
+        auto seq = (C(4) + major_triad) * w.dotted()
+                 | (G(3) + major_triad) * h
+                 | (F(3) + major_triad) * q;
+        std::vector<tick_position> ticked;
+        seq.walk(common, timebase{}, [&](const auto &, auto pos) {
+            ticked.push_back(pos);
+        });
+        expect(ticked.size() == 3_ul);
+        expect(ticked[1] == tick_position{1, ticks{1920}});
+        expect(ticked[2] == tick_position{2, ticks{0}});
+        expect(seq.total_ticks(timebase{}) == ticks{8640});
+    };
+
+    "bar_count over wide durations"_test = [] {
+        wide_duration piece{360000, 7};
+        expect(common.bar_count(piece) == 51428);
+        expect(common.remainder(piece) == wide_duration{4, 7});
+        expect(time_signature{3, 4}.bar_count(wide_duration{900, 1}) == 1200);
+    };
+
+    "walk handles mixed tuplets within a bar"_test = [] {
+        auto m = C(4) * duration{1, 7} | D(4) * duration{1, 5} | E(4) * duration{1, 9}
+               | F(4) * duration{1, 11} | G(4) * w.dotted() | A(4) * w;
+        std::vector<metric_position> positions;
+        m.walk(common, [&](const auto &, auto pos) { positions.push_back(pos); });
+        expect(positions[4].bar == 0_i);
+        expect(positions[4].offset == duration{1888, 3465});
+        expect(positions[5].bar == 2_i);
+        expect(positions[5].offset == duration{311, 6930});
+    };
+
+    "metric position arithmetic"_test = [] {
+        constexpr metric_position start{3, {1, 4}};
+        static_assert(start.elapsed(common) == duration{13, 4});
+        static_assert(start.advanced(w * 500, common).bar == 503);
+        static_assert(start.advanced(duration{7, 8}, waltz).bar == 4);
+        static_assert(start.advanced(duration{7, 8}, waltz).offset == duration{3, 8});
+        static_assert(start.rewound(duration{1, 2}, common).bar == 2);
+        static_assert(start.rewound(duration{1, 2}, common).offset == duration{3, 4});
+        static_assert(position_at(duration{29, 8}, six_eight).bar == 4);
+        static_assert(position_at(duration{29, 8}, six_eight).offset == duration{5, 8});
+        expect(distance(metric_position{1, {1, 2}}, metric_position{9, {1, 8}}, common)
+               == duration{61, 8});
+        expect(distance(metric_position{9, {1, 8}}, metric_position{1, {1, 2}}, common)
+               == duration{-61, 8});
+    };
 }
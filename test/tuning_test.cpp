@@ -0,0 +1,86 @@
+#include <boost/ut.hpp>
+#include <musicpp/tuning.hpp>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+int main() {
+    using namespace boost::ut;
+    using namespace musicpp;
+    using namespace musicpp::notes;
+    using namespace musicpp::intervals;
+
+    auto near = [](double a, double b, double eps = 1e-9) {
+        return std::abs(a - b) <= eps * std::max(1.0, std::abs(b));
+    };
+
+    "equal temperament"_test = [&] {
+        auto et = tuning::equal_temperament();
+        expect(et.frequency(A(4)) == 440.0);
+        expect(near(et.frequency(A(5)), 880.0));
+        expect(near(et.frequency(C(4)), 261.6255653005986));
+        expect(near(et.frequency(Gs(4)), et.frequency(Ab(4))));
+        expect(near(et.cents(C(4), G(4)), 700.0));
+        expect(near(et.fifth_cents(), 700.0));
+
+        auto baroque = tuning::equal_temperament({A(4), 415.0});
+        expect(near(baroque.frequency(A(3)), 207.5));
+        auto c_ref = tuning::equal_temperament({C(4), 256.0});
+        expect(near(c_ref.frequency(C(2)), 64.0));
+    };
+
+    "pythagorean and meantone"_test = [&] {
+        auto py = tuning::pythagorean();
+        expect(near(py.frequency(E(4)) / py.frequency(C(4)), 81.0 / 64.0));
+        expect(near(py.frequency(G(4)) / py.frequency(C(4)), 1.5));
+        expect(py.frequency(Gs(4)) > py.frequency(Ab(4)));
+
+        auto mt = tuning::quarter_comma_meantone();
+        expect(near(mt.frequency(E(4)) / mt.frequency(C(4)), 1.25));
+        expect(near(mt.frequency(A(4)), 440.0));
+        expect(mt.frequency(Gs(4)) < mt.frequency(Ab(4)));
+
+        auto nineteen = tuning::regular(1200.0 * 11.0 / 19.0);
+        expect(near(nineteen.cents(C(4), Cs(4)), 1200.0 / 19.0, 1e-6));
+    };
+
+    "five-limit just intonation"_test = [&] {
+        auto ji = tuning::just_intonation(C, {C(4), 264.0});
+        auto ratio = [&](const note &n) { return ji.frequency(n) / 264.0; };
+        expect(near(ratio(D(4)), 9.0 / 8.0));
+        expect(near(ratio(Eb(4)), 6.0 / 5.0));
+        expect(near(ratio(E(4)), 5.0 / 4.0));
+        expect(near(ratio(F(4)), 4.0 / 3.0));
+        expect(near(ratio(Fs(4)), 45.0 / 32.0));
+        expect(near(ratio(G(4)), 3.0 / 2.0));
+        expect(near(ratio(Ab(4)), 8.0 / 5.0));
+        expect(near(ratio(A(4)), 5.0 / 3.0));
+        expect(near(ratio(Bb(4)), 9.0 / 5.0));
+        expect(near(ratio(B(4)), 15.0 / 8.0));
+        expect(near(ratio(Db(4)), 16.0 / 15.0));
+        expect(near(ratio(C(5)), 2.0));
+
+        auto in_d = tuning::just_intonation(D);
+        expect(near(in_d.frequency(A(4)), 440.0));
+        expect(near(in_d.frequency(Fs(4)) / in_d.frequency(D(4)), 5.0 / 4.0));
+    };
+
+    "batch conversion matches scalar lookup"_test = [&] {
+        auto mt = tuning::quarter_comma_meantone();
+        std::array<note, 6> voices{C(2), Eb(3), Gs(4), B(5), Gb(6), Cs(1)};
+        std::array<double, 6> hz{};
+        std::array<float, 4> hz_f{};
+        expect(mt.frequencies(voices, hz).size() == 6_u);
+        expect(mt.frequencies(voices, hz_f).size() == 4_u);
+        for (std::size_t i = 0; i < voices.size(); ++i) {
+            expect(hz[i] == mt.frequency(voices[i]));
+            if (i < hz_f.size())
+                expect(hz_f[i] == static_cast<float>(hz[i]));
+        }
+    };
+
+    "invalid references are rejected"_test = [] {
+        expect(throws<std::invalid_argument>([] { (void)tuning::equal_temperament({A(4), 0.0}); }));
+        expect(throws<std::invalid_argument>([] { (void)tuning::regular(NAN); }));
+    };
+}